@@ -0,0 +1,49 @@
+#ifndef YK_AGGREGATE_EXCEPTION_HPP
+#define YK_AGGREGATE_EXCEPTION_HPP
+
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace yk {
+
+// Every exception collected from a parallel job (up to a cap),
+// plus the number of the ones that were dropped beyond it.
+class aggregate_exception : public std::runtime_error {
+public:
+  using container_type = std::vector<std::exception_ptr>;
+  using const_iterator = container_type::const_iterator;
+  using size_type = std::size_t;
+
+  explicit aggregate_exception(container_type exceptions, size_type dropped_count = 0)
+    : std::runtime_error("one or more exceptions occurred")
+    , exceptions_(std::move(exceptions))
+    , dropped_count_(dropped_count)
+  {}
+
+  [[nodiscard]] const_iterator begin() const noexcept { return exceptions_.begin(); }
+  [[nodiscard]] const_iterator end() const noexcept { return exceptions_.end(); }
+
+  [[nodiscard]] const std::exception_ptr& operator[](size_type i) const noexcept { return exceptions_[i]; }
+
+  // retained exceptions
+  [[nodiscard]] size_type size() const noexcept { return exceptions_.size(); }
+
+  [[nodiscard]] size_type dropped_count() const noexcept { return dropped_count_; }
+
+  // retained + dropped
+  [[nodiscard]] size_type total_count() const noexcept { return exceptions_.size() + dropped_count_; }
+
+  [[nodiscard]] const container_type& exceptions() const noexcept { return exceptions_; }
+
+private:
+  container_type exceptions_;
+  size_type dropped_count_;
+};
+
+}  // namespace yk
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef YK_ALLOCATOR_ARENA_HPP
+#define YK_ALLOCATOR_ARENA_HPP
+
+#include "yk/allocator/concepts.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yk {
+
+// Thread-safe monotonic (bump-pointer) memory resource.
+//
+// Allocation is a single fetch_add on the current block; deallocation is a no-op.
+// All memory is reclaimed at once by reset(), which keeps the blocks for reuse,
+// so a workload that is reset between runs stops calling malloc after the first run.
+class arena {
+public:
+  static constexpr std::size_t default_block_size = std::size_t{64} * 1024;
+
+  explicit arena(std::size_t block_size = default_block_size)
+      : block_size_(std::max(block_size, sizeof(block) * 2)) {
+    head_ = new_block(block_size_);
+    current_.store(head_, std::memory_order_relaxed);
+  }
+
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  ~arena() {
+    for (block* b = head_; b;) {
+      block* next = b->next;
+      delete_block(b);
+      b = next;
+    }
+  }
+
+  // thread-safe
+  [[nodiscard]]
+  void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+    // blocks start at a max_align_t boundary; keep every allocation on one so that
+    // the common case needs no per-allocation padding
+    const std::size_t reserve = align <= alignof(std::max_align_t) ? round_up(std::max<std::size_t>(bytes, 1), alignof(std::max_align_t)) : bytes + align - 1;
+
+    while (true) {
+      block* b = current_.load(std::memory_order_acquire);
+
+      const std::size_t ofs = b->used.fetch_add(reserve, std::memory_order_relaxed);
+      if (ofs + reserve <= b->size) {
+        const auto addr = reinterpret_cast<std::uintptr_t>(b->data()) + ofs;
+        return reinterpret_cast<void*>(round_up(addr, align));
+      }
+
+      std::unique_lock lock{mtx_};
+      if (current_.load(std::memory_order_relaxed) != b) continue;  // someone else moved on
+
+      // reuse the blocks retained by reset() before asking for more memory
+      block* next = b->next;
+      while (next && next->size < reserve) next = next->next;
+
+      if (!next) {
+        next = new_block(std::max(block_size_, reserve));
+        next->next = b->next;
+        b->next = next;
+      }
+      current_.store(next, std::memory_order_release);
+    }
+  }
+
+  // thread-safe
+  void deallocate(void*, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {}
+
+  // not thread-safe
+  // invalidates every pointer handed out so far
+  void reset() noexcept {
+    for (block* b = head_; b; b = b->next) {
+      b->used.store(0, std::memory_order_relaxed);
+    }
+    current_.store(head_, std::memory_order_relaxed);
+  }
+
+  // not thread-safe
+  // total size of the blocks owned by this arena
+  [[nodiscard]]
+  std::size_t capacity() const noexcept {
+    std::size_t sum = 0;
+    for (const block* b = head_; b; b = b->next) sum += b->size;
+    return sum;
+  }
+
+private:
+  struct alignas(std::max_align_t) block {
+    block* next = nullptr;
+    std::size_t size = 0;
+    std::atomic<std::size_t> used = 0;
+
+    [[nodiscard]]
+    std::byte* data() noexcept {
+      return reinterpret_cast<std::byte*>(this) + sizeof(block);
+    }
+  };
+
+  [[nodiscard]]
+  static constexpr std::size_t round_up(std::size_t n, std::size_t align) noexcept {
+    return (n + align - 1) / align * align;
+  }
+
+  [[nodiscard]]
+  static block* new_block(std::size_t size) {
+    void* ptr = ::operator new(sizeof(block) + size);
+    block* b = ::new (ptr) block;
+    b->size = size;
+    return b;
+  }
+
+  static void delete_block(block* b) noexcept {
+    const std::size_t size = b->size;
+    b->~block();
+    ::operator delete(static_cast<void*>(b), sizeof(block) + size);
+  }
+
+  std::size_t block_size_;
+  block* head_ = nullptr;
+  std::atomic<block*> current_ = nullptr;
+  std::mutex mtx_;
+};
+
+// Allocator that draws from an arena; deallocate() is a no-op.
+template <class T>
+class arena_allocator {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  constexpr arena_allocator(arena& a) noexcept : arena_(&a) {}
+
+  template <class U>
+  constexpr arena_allocator(const arena_allocator<U>& other) noexcept : arena_(other.get_arena()) {}
+
+  [[nodiscard]]
+  constexpr arena* get_arena() const noexcept { return arena_; }
+
+  [[nodiscard]]
+  T* allocate(size_type n) {
+    if (n > static_cast<size_type>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length{};
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_type) noexcept {}
+
+  template <class U>
+  [[nodiscard]]
+  friend constexpr bool operator==(const arena_allocator& lhs, const arena_allocator<U>& rhs) noexcept {
+    return lhs.get_arena() == rhs.get_arena();
+  }
+
+private:
+  arena* arena_;
+};
+
+static_assert(xo::simple_allocator<arena_allocator<int>>);
+
+}  // namespace yk
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef YK_ALLOCATOR_HUGE_PAGE_ALLOCATOR_HPP
+#define YK_ALLOCATOR_HUGE_PAGE_ALLOCATOR_HPP
+
+#include "yk/allocator/concepts.hpp"
+
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include <cstddef>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace yk {
+
+namespace detail {
+
+inline constexpr int huge_page_shift = 21;
+inline constexpr std::size_t huge_page_size = std::size_t{1} << huge_page_shift;
+
+// Alignment guaranteed by the regular-page fallback mapping.
+inline constexpr std::size_t min_page_size = 4096;
+
+// Allocations smaller than this go through the global operator new;
+// rounding them up to a whole huge page would waste more than it saves.
+inline constexpr std::size_t huge_page_threshold = huge_page_size / 2;
+
+[[nodiscard]]
+constexpr std::size_t round_up_to_huge_page(std::size_t bytes) noexcept {
+  return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+#if defined(__linux__)
+
+// Tries MAP_HUGETLB first (requires reserved huge pages), then falls back
+// to regular pages with transparent huge pages requested via madvise.
+// The huge page size is requested explicitly so that munmap of the rounded-up
+// length matches the mapping even when the system default is not 2 MiB.
+[[nodiscard]]
+inline void* huge_page_map(std::size_t bytes, int numa_node) noexcept {
+  void* ptr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (huge_page_shift << MAP_HUGE_SHIFT), -1, 0);
+#endif
+
+  if (ptr == MAP_FAILED) {
+    ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return nullptr;
+
+#if defined(MADV_HUGEPAGE)
+    (void)::madvise(ptr, bytes, MADV_HUGEPAGE); // best effort
+#endif
+  }
+
+#if defined(SYS_mbind)
+  // Bind before the first touch so that the pages are faulted in on the node.
+  // Issued as a raw syscall to avoid the libnuma dependency; failure is ignored.
+  if (numa_node >= 0 && numa_node < static_cast<int>(std::numeric_limits<unsigned long>::digits)) {
+    constexpr int mpol_preferred = 1; // MPOL_PREFERRED; falls back to other nodes on shortage
+    const unsigned long node_mask = 1ul << numa_node;
+    (void)::syscall(SYS_mbind, ptr, bytes, mpol_preferred, &node_mask, std::numeric_limits<unsigned long>::digits + 1, 0u);
+  }
+#else
+  (void)numa_node;
+#endif
+
+  return ptr;
+}
+
+inline void huge_page_unmap(void* ptr, std::size_t bytes) noexcept {
+  (void)::munmap(ptr, bytes);
+}
+
+#endif // __linux__
+
+}  // namespace detail
+
+// Allocator for large, long-lived buffers (e.g. the slots of a multi-GB atomic_queue).
+//
+// Large allocations are mapped directly and backed by huge pages when available:
+// explicit huge pages (MAP_HUGETLB) first, then transparent huge pages (MADV_HUGEPAGE).
+// If numa_node >= 0, the memory is preferably placed on that node.
+// Small allocations, over-aligned types, and every allocation on non-Linux platforms, use the global operator new.
+// Every instance can deallocate memory allocated by any other, so all instances compare equal.
+template <class T>
+class huge_page_allocator {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  static constexpr int any_numa_node = -1;
+
+  constexpr huge_page_allocator() noexcept = default;
+
+  constexpr explicit huge_page_allocator(int numa_node) noexcept
+    : numa_node_(numa_node)
+  {}
+
+  template <class U>
+  constexpr huge_page_allocator(const huge_page_allocator<U>& other) noexcept
+    : numa_node_(other.numa_node())
+  {}
+
+  [[nodiscard]]
+  constexpr int numa_node() const noexcept { return numa_node_; }
+
+  [[nodiscard]]
+  T* allocate(size_type n) {
+    if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+      throw std::bad_array_new_length{};
+    }
+    const size_type bytes = n * sizeof(T);
+
+#if defined(__linux__)
+    if (bytes >= detail::huge_page_threshold && alignof(T) <= detail::min_page_size) {
+      void* ptr = detail::huge_page_map(detail::round_up_to_huge_page(bytes), numa_node_);
+      if (!ptr) throw std::bad_alloc{};
+      return static_cast<T*>(ptr);
+    }
+#endif
+
+    return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+  }
+
+  void deallocate(T* ptr, size_type n) noexcept {
+    const size_type bytes = n * sizeof(T);
+
+#if defined(__linux__)
+    if (bytes >= detail::huge_page_threshold && alignof(T) <= detail::min_page_size) {
+      detail::huge_page_unmap(ptr, detail::round_up_to_huge_page(bytes));
+      return;
+    }
+#endif
+
+    ::operator delete(ptr, bytes, std::align_val_t{alignof(T)});
+  }
+
+  template <class U>
+  [[nodiscard]]
+  friend constexpr bool operator==(const huge_page_allocator&, const huge_page_allocator<U>&) noexcept {
+    return true;
+  }
+
+private:
+  int numa_node_ = any_numa_node;
+};
+
+static_assert(xo::simple_allocator<huge_page_allocator<int>>);
+
+}  // namespace yk
+
+#endif
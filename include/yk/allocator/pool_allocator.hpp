@@ -0,0 +1,171 @@
+#ifndef YK_ALLOCATOR_POOL_ALLOCATOR_HPP
+#define YK_ALLOCATOR_POOL_ALLOCATOR_HPP
+
+#include "yk/allocator/concepts.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <new>
+#include <type_traits>
+
+#include <cstddef>
+
+namespace yk {
+
+namespace detail {
+
+// Per-thread free lists, one per power-of-two size class in [16, 4096] bytes.
+//
+// Blocks may be freed on a different thread than the one that allocated them
+// (e.g. producer -> consumer); they simply migrate to the freeing thread's cache.
+// Each list is capped so that a thread that only frees does not hoard memory.
+class pool_thread_cache {
+public:
+  static constexpr std::size_t min_class_size = 16;
+  static constexpr std::size_t max_class_size = 4096;
+  static constexpr std::size_t class_count = std::countr_zero(max_class_size) - std::countr_zero(min_class_size) + 1;
+
+  // upper bound of the cached bytes per size class
+  static constexpr std::size_t max_cached_bytes = std::size_t{256} * 1024;
+
+  pool_thread_cache() = default;
+  pool_thread_cache(const pool_thread_cache&) = delete;
+  pool_thread_cache& operator=(const pool_thread_cache&) = delete;
+
+  ~pool_thread_cache() {
+    destroyed() = true;
+    for (std::size_t c = 0; c < class_count; ++c) {
+      while (node* n = lists_[c].head) {
+        lists_[c].head = n->next;
+        ::operator delete(static_cast<void*>(n), class_size(c));
+      }
+    }
+  }
+
+  [[nodiscard]]
+  static constexpr bool is_pooled(std::size_t bytes, std::size_t align) noexcept {
+    return bytes <= max_class_size && align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  }
+
+  [[nodiscard]]
+  static constexpr std::size_t class_of(std::size_t bytes) noexcept {
+    return static_cast<std::size_t>(std::countr_zero(std::bit_ceil(std::max(bytes, min_class_size)))) - std::countr_zero(min_class_size);
+  }
+
+  [[nodiscard]]
+  static constexpr std::size_t class_size(std::size_t c) noexcept { return min_class_size << c; }
+
+  // returns nullptr once the calling thread's cache has been destroyed
+  [[nodiscard]]
+  static pool_thread_cache* instance() noexcept {
+    if (destroyed()) return nullptr;
+    thread_local pool_thread_cache cache;
+    return &cache;
+  }
+
+  [[nodiscard]]
+  void* allocate(std::size_t c) {
+    if (node* n = lists_[c].head) {
+      lists_[c].head = n->next;
+      --lists_[c].count;
+      return n;
+    }
+    return ::operator new(class_size(c));
+  }
+
+  void deallocate(void* ptr, std::size_t c) noexcept {
+    auto& list = lists_[c];
+    if (list.count >= max_cached_bytes / class_size(c)) {
+      ::operator delete(ptr, class_size(c));
+      return;
+    }
+    list.head = ::new (ptr) node{list.head};
+    ++list.count;
+  }
+
+private:
+  struct node {
+    node* next;
+  };
+
+  struct free_list {
+    node* head = nullptr;
+    std::size_t count = 0;
+  };
+
+  // trivially destructible, so it stays valid during the destruction of other thread_local objects
+  [[nodiscard]]
+  static bool& destroyed() noexcept {
+    thread_local constinit bool flag = false;
+    return flag;
+  }
+
+  std::array<free_list, class_count> lists_{};
+};
+
+}  // namespace detail
+
+// Stateless allocator backed by per-thread, size-classed free lists.
+// Suited for many short-lived small objects (strings, vectors, nodes, ...);
+// requests larger than 4096 bytes or over-aligned go to the global operator new.
+template <class T>
+class pool_allocator {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  constexpr pool_allocator() noexcept = default;
+
+  template <class U>
+  constexpr pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  [[nodiscard]]
+  T* allocate(size_type n) {
+    if (n > static_cast<size_type>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length{};
+    }
+    const size_type bytes = n * sizeof(T);
+
+    if (detail::pool_thread_cache::is_pooled(bytes, alignof(T))) {
+      const auto c = detail::pool_thread_cache::class_of(bytes);
+      if (auto* cache = detail::pool_thread_cache::instance()) {
+        return static_cast<T*>(cache->allocate(c));
+      }
+      return static_cast<T*>(::operator new(detail::pool_thread_cache::class_size(c)));
+    }
+
+    return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+  }
+
+  void deallocate(T* ptr, size_type n) noexcept {
+    const size_type bytes = n * sizeof(T);
+
+    if (detail::pool_thread_cache::is_pooled(bytes, alignof(T))) {
+      const auto c = detail::pool_thread_cache::class_of(bytes);
+      if (auto* cache = detail::pool_thread_cache::instance()) {
+        cache->deallocate(ptr, c);
+        return;
+      }
+      ::operator delete(static_cast<void*>(ptr), detail::pool_thread_cache::class_size(c));
+      return;
+    }
+
+    ::operator delete(static_cast<void*>(ptr), bytes, std::align_val_t{alignof(T)});
+  }
+
+  template <class U>
+  [[nodiscard]]
+  friend constexpr bool operator==(const pool_allocator&, const pool_allocator<U>&) noexcept {
+    return true;
+  }
+};
+
+static_assert(xo::simple_allocator<pool_allocator<int>>);
+
+}  // namespace yk
+
+#endif
@@ -5,6 +5,7 @@
 #include "yk/enum_bitops.hpp"
 #include "yk/enum_bitops_algorithm.hpp"
 #include "yk/fixed_string.hpp"
+#include "yk/perfect_hash_map.hpp"
 
 #include <algorithm>
 #include <array>
@@ -243,13 +244,9 @@ private:
   std::optional<rgb_color> value;
 };
 
-struct color_pair {
-  std::string_view name;
-  color value;
-};
+using color_pair = std::pair<std::string_view, color>;
 
 static constexpr auto color_lookup_table = [] {
-  using namespace std::string_view_literals;
   std::array table{
       color_pair{"black", rgb_color::black},
       color_pair{"dimgray", rgb_color::dimgray},
@@ -395,15 +392,14 @@ static constexpr auto color_lookup_table = [] {
       color_pair{"pink", rgb_color::pink},
       color_pair{"lightpink", rgb_color::lightpink},
   };
-  std::ranges::sort(table, {}, &color_pair::name);
-  return table;
+  return make_perfect_hash_map(table);
 }();
 
 static constexpr color name_to_color(std::string_view name)
 {
-  auto it = std::ranges::lower_bound(color_lookup_table, name, {}, &color_pair::name);
-  if (it == color_lookup_table.end() || it->name != name) return color{};
-  return it->value;
+  auto it = color_lookup_table.find(name);
+  if (it == color_lookup_table.end()) return color{};
+  return it->second;
 }
 
 enum class emphasis : uint8_t {
@@ -419,15 +415,11 @@ enum class emphasis : uint8_t {
 
 static constexpr emphasis name_to_emphasis(std::string_view name)
 {
-  if (name == "bold") return emphasis::bold;
-  if (name == "faint") return emphasis::faint;
-  if (name == "italic") return emphasis::italic;
-  if (name == "underline") return emphasis::underline;
-  if (name == "blink") return emphasis::blink;
-  if (name == "reverse") return emphasis::reverse;
-  if (name == "conceal") return emphasis::conceal;
-  if (name == "strike") return emphasis::strike;
-  return emphasis{};
+  // in the order of the bits
+  constexpr auto& table = perfect_hash_index<"bold", "faint", "italic", "underline", "blink", "reverse", "conceal", "strike">;
+  auto it = table.find(name);
+  if (it == table.end()) return emphasis{};
+  return static_cast<emphasis>(1 << it->second);
 }
 
 static constexpr std::uint8_t emphasis_to_value(emphasis em)
@@ -0,0 +1,682 @@
+#ifndef YK_DETAIL_RAW_HASH_TABLE_HPP
+#define YK_DETAIL_RAW_HASH_TABLE_HPP
+
+#include "yk/hash/hash_bytes.hpp"
+#include "yk/no_unique_address.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef YK_HASH_TABLE_SSE2
+# if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define YK_HASH_TABLE_SSE2 1
+# else
+#  define YK_HASH_TABLE_SSE2 0
+# endif
+#endif
+
+#if YK_HASH_TABLE_SSE2
+# include <emmintrin.h>
+#endif
+
+// SwissTable-style open addressing: one control byte per slot, probed 16 at a time.
+//   empty   = 0b1000'0000
+//   deleted = 0b1111'1110
+//   full    = 0b0xxx'xxxx (the low 7 bits of the hash, "H2")
+// The remaining bits of the hash ("H1") select the first group to probe; groups
+// are aligned and probed quadratically, so no control byte is ever cloned.
+
+namespace yk::detail {
+
+namespace swiss {
+
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t ctrl_empty = -128;
+inline constexpr ctrl_t ctrl_deleted = -2;
+
+// 16 control bytes; every match_* returns a bitmask with bit i set for byte i
+class group {
+public:
+  static constexpr std::size_t width = 16;
+
+#if YK_HASH_TABLE_SSE2
+  explicit group(const ctrl_t* p) noexcept : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+  [[nodiscard]] std::uint32_t match(ctrl_t h2) const noexcept {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+  }
+
+  [[nodiscard]] std::uint32_t match_empty() const noexcept { return match(ctrl_empty); }
+
+  // empty and deleted are the only values below -1
+  [[nodiscard]] std::uint32_t match_empty_or_deleted() const noexcept {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_)));
+  }
+
+private:
+  __m128i ctrl_;
+
+#else
+  explicit group(const ctrl_t* p) noexcept : ctrl_(p) {}
+
+  [[nodiscard]] std::uint32_t match(ctrl_t h2) const noexcept {
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < width; ++i) mask |= std::uint32_t{ctrl_[i] == h2} << i;
+    return mask;
+  }
+
+  [[nodiscard]] std::uint32_t match_empty() const noexcept { return match(ctrl_empty); }
+
+  [[nodiscard]] std::uint32_t match_empty_or_deleted() const noexcept {
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < width; ++i) mask |= std::uint32_t{ctrl_[i] < -1} << i;
+    return mask;
+  }
+
+private:
+  const ctrl_t* ctrl_;
+#endif
+};
+
+// visits every group once when the group count is a power of two
+struct probe_seq {
+  std::size_t mask;
+  std::size_t offset;
+  std::size_t index = 0;
+
+  [[nodiscard]] std::size_t group_offset() const noexcept { return offset * group::width; }
+
+  void next() noexcept {
+    ++index;
+    offset = (offset + index) & mask;
+  }
+};
+
+[[nodiscard]] constexpr std::size_t h1(std::uint64_t h) noexcept { return static_cast<std::size_t>(h >> 7); }
+[[nodiscard]] constexpr ctrl_t h2(std::uint64_t h) noexcept { return static_cast<ctrl_t>(h & 0x7F); }
+
+// max load factor 7/8
+[[nodiscard]] constexpr std::size_t growth_capacity(std::size_t capacity) noexcept { return capacity - capacity / 8; }
+
+[[nodiscard]] constexpr std::size_t capacity_for(std::size_t n) noexcept {
+  if (n == 0) return 0;
+  std::size_t capacity = group::width;
+  while (growth_capacity(capacity) < n) capacity *= 2;
+  return capacity;
+}
+
+}  // namespace swiss
+
+template <class Hash, class KeyEqual>
+concept transparent_hash_table = requires {
+  typename Hash::is_transparent;
+  typename KeyEqual::is_transparent;
+};
+
+// Policy:
+//   key_type, value_type, init_type (value_type with a mutable key)
+//   static const key_type& key(const value_type& or const init_type&)
+//   static void transfer(Alloc&, value_type* dst, value_type* src)  moves *src into *dst and destroys *src
+template <class Policy, class Hash, class KeyEqual, class Allocator>
+class raw_hash_table {
+  using ctrl_t = swiss::ctrl_t;
+  using group = swiss::group;
+
+  using ctrl_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<ctrl_t>;
+  using slot_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<typename Policy::value_type>;
+  using ctrl_traits = std::allocator_traits<ctrl_allocator_type>;
+  using slot_traits = std::allocator_traits<slot_allocator_type>;
+
+  static constexpr bool is_transparent = transparent_hash_table<Hash, KeyEqual>;
+
+public:
+  using key_type = typename Policy::key_type;
+  using value_type = typename Policy::value_type;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+
+  template <bool Const>
+  class basic_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = raw_hash_table::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+    basic_iterator() = default;
+
+    // a template, so that it never suppresses the copy constructor
+    template <bool OtherConst>
+      requires(Const && !OtherConst)
+    basic_iterator(const basic_iterator<OtherConst>& other) noexcept : ctrl_(other.ctrl_), ctrl_end_(other.ctrl_end_), slot_(other.slot_) {}
+
+    [[nodiscard]] reference operator*() const noexcept { return *slot_; }
+    [[nodiscard]] pointer operator->() const noexcept { return slot_; }
+
+    basic_iterator& operator++() noexcept {
+      ++ctrl_;
+      ++slot_;
+      skip_non_full();
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    [[nodiscard]] friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.slot_ == b.slot_; }
+
+  private:
+    friend raw_hash_table;
+    friend basic_iterator<!Const>;
+
+    basic_iterator(const ctrl_t* ctrl, const ctrl_t* ctrl_end, value_type* slot) noexcept : ctrl_(ctrl), ctrl_end_(ctrl_end), slot_(slot) {}
+
+    void skip_non_full() noexcept {
+      while (ctrl_ != ctrl_end_ && *ctrl_ < 0) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    const ctrl_t* ctrl_ = nullptr;
+    const ctrl_t* ctrl_end_ = nullptr;
+    value_type* slot_ = nullptr;
+  };
+
+  using iterator = basic_iterator<Policy::constant_iterators>;
+  using const_iterator = basic_iterator<true>;
+
+  raw_hash_table() noexcept(std::is_nothrow_default_constructible_v<Hash> && std::is_nothrow_default_constructible_v<KeyEqual> &&
+                            std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+  explicit raw_hash_table(size_type bucket_count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+      : hash_(hash), eq_(equal), alloc_(alloc) {
+    rehash(bucket_count);
+  }
+
+  raw_hash_table(size_type bucket_count, const Allocator& alloc) : raw_hash_table(bucket_count, Hash(), KeyEqual(), alloc) {}
+
+  explicit raw_hash_table(const Allocator& alloc) : alloc_(alloc) {}
+
+  template <std::input_iterator InputIt>
+  raw_hash_table(InputIt first, InputIt last, size_type bucket_count = 0, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                 const Allocator& alloc = Allocator())
+      : raw_hash_table(bucket_count, hash, equal, alloc) {
+    guarded([&] { insert(first, last); });
+  }
+
+  raw_hash_table(std::initializer_list<value_type> il, size_type bucket_count = 0, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                 const Allocator& alloc = Allocator())
+      : raw_hash_table(il.begin(), il.end(), bucket_count, hash, equal, alloc) {}
+
+  raw_hash_table(const raw_hash_table& other) : raw_hash_table(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc_)) {}
+
+  raw_hash_table(const raw_hash_table& other, const Allocator& alloc) : hash_(other.hash_), eq_(other.eq_), alloc_(alloc) {
+    reserve(other.size_);
+    guarded([&] {
+      for (const auto& value : other) emplace_unique_unchecked(hash_of(Policy::key(value)), value);
+    });
+  }
+
+  raw_hash_table(raw_hash_table&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        growth_left_(std::exchange(other.growth_left_, 0)),
+        hash_(std::move(other.hash_)),
+        eq_(std::move(other.eq_)),
+        alloc_(std::move(other.alloc_)) {}
+
+  ~raw_hash_table() { destroy_and_deallocate(); }
+
+  raw_hash_table& operator=(const raw_hash_table& other) {
+    if (this != &other) {
+      raw_hash_table tmp(other, std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_);
+      swap_all(tmp);
+    }
+    return *this;
+  }
+
+  raw_hash_table& operator=(raw_hash_table&& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value ||
+                                                             std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+    if (this == &other) return *this;
+    if constexpr (std::allocator_traits<Allocator>::is_always_equal::value ||
+                  std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+      raw_hash_table tmp(std::move(other));
+      swap_all(tmp);
+    } else if (alloc_ == other.alloc_) {
+      raw_hash_table tmp(std::move(other));
+      swap_all(tmp);
+    } else {
+      clear();
+      hash_ = other.hash_;
+      eq_ = other.eq_;
+      reserve(other.size_);
+      for (auto& value : other) emplace_unique_unchecked(hash_of(Policy::key(value)), std::move(value));
+      other.clear();
+    }
+    return *this;
+  }
+
+  raw_hash_table& operator=(std::initializer_list<value_type> il) {
+    clear();
+    insert(il);
+    return *this;
+  }
+
+  [[nodiscard]] allocator_type get_allocator() const noexcept { return alloc_; }
+
+  // iterators
+
+  [[nodiscard]] iterator begin() noexcept { return iterator_at(0, true); }
+  [[nodiscard]] const_iterator begin() const noexcept { return const_cast<raw_hash_table&>(*this).iterator_at(0, true); }
+  [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+  [[nodiscard]] iterator end() noexcept { return iterator_at(capacity_, false); }
+  [[nodiscard]] const_iterator end() const noexcept { return const_cast<raw_hash_table&>(*this).iterator_at(capacity_, false); }
+  [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+  // capacity
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] size_type size() const noexcept { return size_; }
+  [[nodiscard]] size_type max_size() const noexcept { return std::min(slot_traits::max_size(slot_allocator_type(alloc_)), std::numeric_limits<size_type>::max() / 2); }
+
+  // modifiers
+
+  // keeps the capacity
+  void clear() noexcept {
+    if (size_ != 0) {
+      destroy_all();
+      std::fill_n(ctrl_, capacity_, swiss::ctrl_empty);
+    } else if (growth_left_ == swiss::growth_capacity(capacity_)) {
+      return;
+    } else {
+      std::fill_n(ctrl_, capacity_, swiss::ctrl_empty);
+    }
+    size_ = 0;
+    growth_left_ = swiss::growth_capacity(capacity_);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) { return emplace_unique(Policy::key(value), value); }
+  std::pair<iterator, bool> insert(value_type&& value) { return emplace_unique(Policy::key(value), std::move(value)); }
+
+  iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+  iterator insert(const_iterator, value_type&& value) { return insert(std::move(value)).first; }
+
+  template <std::input_iterator InputIt>
+  void insert(InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+    for (; first != last; ++first) emplace(*first);
+  }
+
+  void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+  // constructs the element out of place to find its key
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, value_type> && ...)) {
+      return insert(std::forward<Args>(args)...);
+    } else {
+      typename Policy::init_type tmp(std::forward<Args>(args)...);
+      return emplace_unique(Policy::key(tmp), std::move(tmp));
+    }
+  }
+
+  template <class... Args>
+  iterator emplace_hint(const_iterator, Args&&... args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  iterator erase(iterator pos) noexcept
+    requires(!std::is_same_v<iterator, const_iterator>)
+  {
+    return erase(const_iterator(pos));
+  }
+
+  iterator erase(const_iterator pos) noexcept {
+    const size_type i = index_of(pos);
+    erase_at(i);
+    return iterator_at(i + 1, true);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) noexcept {
+    while (first != last) first = erase(first);
+    return iterator_at(index_of(last), false);
+  }
+
+  size_type erase(const key_type& key) noexcept { return erase_key(key); }
+
+  template <class K>
+    requires is_transparent && (!std::is_convertible_v<K, const_iterator>)
+  size_type erase(K&& key) noexcept {
+    return erase_key(key);
+  }
+
+  void swap(raw_hash_table& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value ||
+                                            std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+    using std::swap;
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) swap(alloc_, other.alloc_);
+    swap_table(other);
+  }
+
+  friend void swap(raw_hash_table& a, raw_hash_table& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+  // lookup
+
+  [[nodiscard]] iterator find(const key_type& key) noexcept { return iterator_at(find_index(key, hash_of(key)), false); }
+  [[nodiscard]] const_iterator find(const key_type& key) const noexcept { return const_cast<raw_hash_table&>(*this).find(key); }
+
+  template <class K>
+    requires is_transparent
+  [[nodiscard]] iterator find(const K& key) noexcept {
+    return iterator_at(find_index(key, hash_of(key)), false);
+  }
+
+  template <class K>
+    requires is_transparent
+  [[nodiscard]] const_iterator find(const K& key) const noexcept {
+    return const_cast<raw_hash_table&>(*this).find(key);
+  }
+
+  [[nodiscard]] bool contains(const key_type& key) const noexcept { return find(key) != end(); }
+
+  template <class K>
+    requires is_transparent
+  [[nodiscard]] bool contains(const K& key) const noexcept {
+    return find(key) != end();
+  }
+
+  [[nodiscard]] size_type count(const key_type& key) const noexcept { return contains(key) ? 1 : 0; }
+
+  template <class K>
+    requires is_transparent
+  [[nodiscard]] size_type count(const K& key) const noexcept {
+    return contains(key) ? 1 : 0;
+  }
+
+  // bucket interface / hash policy; a "bucket" is a slot
+
+  [[nodiscard]] size_type bucket_count() const noexcept { return capacity_; }
+
+  [[nodiscard]] float load_factor() const noexcept { return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_); }
+
+  // fixed
+  [[nodiscard]] float max_load_factor() const noexcept { return 0.875f; }
+  void max_load_factor(float) noexcept {}
+
+  // at least `bucket_count` slots, and enough for size() elements; also drops every tombstone
+  void rehash(size_type bucket_count) {
+    const size_type capacity = std::max(swiss::capacity_for(size_), bucket_count == 0 ? 0 : std::bit_ceil(std::max(bucket_count, group::width)));
+    if (capacity == 0) {
+      destroy_and_deallocate();
+      ctrl_ = nullptr;
+      slots_ = nullptr;
+      capacity_ = growth_left_ = 0;
+    } else {
+      resize(capacity);
+    }
+  }
+
+  // room for `count` elements without rehashing
+  void reserve(size_type count) {
+    if (count > size_ + growth_left_) resize(swiss::capacity_for(count));
+  }
+
+  // observers
+
+  [[nodiscard]] hasher hash_function() const { return hash_; }
+  [[nodiscard]] key_equal key_eq() const { return eq_; }
+
+  [[nodiscard]] friend bool operator==(const raw_hash_table& a, const raw_hash_table& b) {
+    if (a.size_ != b.size_) return false;
+    for (const auto& value : a) {
+      const auto it = b.find(Policy::key(value));
+      if (it == b.end() || !(*it == value)) return false;
+    }
+    return true;
+  }
+
+protected:
+  // constructs value_type from args only if the key is absent
+  template <class K, class... Args>
+  std::pair<iterator, bool> emplace_unique(const K& key, Args&&... args) {
+    return emplace_unique_hashed(hash_of(key), key, std::forward<Args>(args)...);
+  }
+
+  // The *_hashed functions take h == hash_of(key), for wrappers that hash once
+  // (e.g. outside of a lock).
+
+  template <class K, class... Args>
+  std::pair<iterator, bool> emplace_unique_hashed(std::uint64_t h, const K& key, Args&&... args) {
+    if (const size_type i = find_index(key, h); i != capacity_) return {iterator_at(i, false), false};
+    return {iterator_at(emplace_unique_unchecked(h, std::forward<Args>(args)...), false), true};
+  }
+
+  template <class K>
+  [[nodiscard]] iterator find_hashed(const K& key, std::uint64_t h) noexcept {
+    return iterator_at(find_index(key, h), false);
+  }
+
+  template <class K>
+  [[nodiscard]] const_iterator find_hashed(const K& key, std::uint64_t h) const noexcept {
+    return const_cast<raw_hash_table&>(*this).find_hashed(key, h);
+  }
+
+  template <class K>
+  size_type erase_hashed(const K& key, std::uint64_t h) noexcept {
+    const size_type i = find_index(key, h);
+    if (i == capacity_) return 0;
+    erase_at(i);
+    return 1;
+  }
+
+  template <class K>
+  [[nodiscard]] size_type find_index(const K& key, std::uint64_t h) const noexcept {
+    if (capacity_ == 0) return capacity_;
+    for (auto seq = probe(h);; seq.next()) {
+      const group g(ctrl_ + seq.group_offset());
+      for (auto mask = g.match(swiss::h2(h)); mask != 0; mask &= mask - 1) {
+        const size_type i = seq.group_offset() + static_cast<size_type>(std::countr_zero(mask));
+        if (eq_(Policy::key(slots_[i]), key)) [[likely]] return i;
+      }
+      if (g.match_empty() != 0) [[likely]] return capacity_;
+    }
+  }
+
+  [[nodiscard]] iterator iterator_at(size_type i, bool skip) noexcept {
+    iterator it(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+    if (skip) it.skip_non_full();
+    return it;
+  }
+
+  template <class K>
+  [[nodiscard]] std::uint64_t hash_of(const K& key) const noexcept {
+    const auto h = static_cast<std::uint64_t>(hash_(key));
+    if constexpr (requires { typename Hash::is_avalanching; }) {
+      return h;
+    } else {
+      // std::hash of an integer is usually the identity; spread it over H1 and H2
+      return wyhash::mix(h, 0x9e3779b97f4a7c15ull);
+    }
+  }
+
+private:
+  [[nodiscard]] swiss::probe_seq probe(std::uint64_t h) const noexcept {
+    const size_type mask = capacity_ / group::width - 1;
+    return {mask, swiss::h1(h) & mask};
+  }
+
+  [[nodiscard]] size_type find_first_non_full(std::uint64_t h) const noexcept {
+    for (auto seq = probe(h);; seq.next()) {
+      if (const auto mask = group(ctrl_ + seq.group_offset()).match_empty_or_deleted(); mask != 0) {
+        return seq.group_offset() + static_cast<size_type>(std::countr_zero(mask));
+      }
+    }
+  }
+
+  template <class... Args>
+  size_type emplace_unique_unchecked(std::uint64_t h, Args&&... args) {
+    size_type i = 0;
+    if (capacity_ != 0) i = find_first_non_full(h);
+    if (capacity_ == 0 || (growth_left_ == 0 && ctrl_[i] != swiss::ctrl_deleted)) {
+      grow();
+      i = find_first_non_full(h);
+    }
+    slot_allocator_type slot_alloc(alloc_);
+    slot_traits::construct(slot_alloc, slots_ + i, std::forward<Args>(args)...);
+    growth_left_ -= ctrl_[i] == swiss::ctrl_empty;
+    ctrl_[i] = swiss::h2(h);
+    ++size_;
+    return i;
+  }
+
+  void grow() {
+    if (capacity_ == 0) {
+      resize(group::width);
+    } else if (size_ <= swiss::growth_capacity(capacity_) / 2) {
+      // mostly tombstones
+      resize(capacity_);
+    } else {
+      resize(capacity_ * 2);
+    }
+  }
+
+  void resize(size_type capacity) {
+    ctrl_allocator_type ctrl_alloc(alloc_);
+    slot_allocator_type slot_alloc(alloc_);
+
+    ctrl_t* const new_ctrl = ctrl_traits::allocate(ctrl_alloc, capacity);
+    value_type* new_slots;
+    try {
+      new_slots = slot_traits::allocate(slot_alloc, capacity);
+    } catch (...) {
+      ctrl_traits::deallocate(ctrl_alloc, new_ctrl, capacity);
+      throw;
+    }
+    std::fill_n(new_ctrl, capacity, swiss::ctrl_empty);
+
+    ctrl_t* const old_ctrl = std::exchange(ctrl_, new_ctrl);
+    value_type* const old_slots = std::exchange(slots_, new_slots);
+    const size_type old_capacity = std::exchange(capacity_, capacity);
+    growth_left_ = swiss::growth_capacity(capacity) - size_;
+
+    for (size_type i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] < 0) continue;
+      const std::uint64_t h = hash_of(Policy::key(old_slots[i]));
+      const size_type j = find_first_non_full(h);
+      Policy::transfer(slot_alloc, slots_ + j, old_slots + i);
+      ctrl_[j] = swiss::h2(h);
+    }
+
+    if (old_capacity != 0) {
+      ctrl_traits::deallocate(ctrl_alloc, old_ctrl, old_capacity);
+      slot_traits::deallocate(slot_alloc, old_slots, old_capacity);
+    }
+  }
+
+  void erase_at(size_type i) noexcept {
+    slot_allocator_type slot_alloc(alloc_);
+    slot_traits::destroy(slot_alloc, slots_ + i);
+    --size_;
+
+    // a probe only continues past a group that has never had an empty byte since the last rehash;
+    // if this group still has one, nobody's probe depends on this slot
+    if (group(ctrl_ + (i & ~(group::width - 1))).match_empty() != 0) {
+      ctrl_[i] = swiss::ctrl_empty;
+      ++growth_left_;
+    } else {
+      ctrl_[i] = swiss::ctrl_deleted;
+    }
+  }
+
+  template <class K>
+  size_type erase_key(const K& key) noexcept {
+    return erase_hashed(key, hash_of(key));
+  }
+
+  [[nodiscard]] size_type index_of(const_iterator it) const noexcept { return static_cast<size_type>(it.slot_ - slots_); }
+
+  void destroy_all() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      slot_allocator_type slot_alloc(alloc_);
+      for (size_type i = 0; i < capacity_; ++i) {
+        if (ctrl_[i] >= 0) slot_traits::destroy(slot_alloc, slots_ + i);
+      }
+    }
+  }
+
+  void destroy_and_deallocate() noexcept {
+    if (capacity_ == 0) return;
+    destroy_all();
+    ctrl_allocator_type ctrl_alloc(alloc_);
+    slot_allocator_type slot_alloc(alloc_);
+    ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_);
+    slot_traits::deallocate(slot_alloc, slots_, capacity_);
+  }
+
+  // releases everything if f throws; for constructors, whose destructor would not run
+  template <class F>
+  void guarded(F&& f) {
+    try {
+      f();
+    } catch (...) {
+      destroy_and_deallocate();
+      throw;
+    }
+  }
+
+  void swap_table(raw_hash_table& other) noexcept {
+    using std::swap;
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+    swap(hash_, other.hash_);
+    swap(eq_, other.eq_);
+  }
+
+  void swap_all(raw_hash_table& other) noexcept {
+    using std::swap;
+    swap(alloc_, other.alloc_);
+    swap_table(other);
+  }
+
+  ctrl_t* ctrl_ = nullptr;
+  value_type* slots_ = nullptr;
+  size_type capacity_ = 0;
+  size_type size_ = 0;
+  size_type growth_left_ = 0;
+
+  YK_NO_UNIQUE_ADDRESS hasher hash_{};
+  YK_NO_UNIQUE_ADDRESS key_equal eq_{};
+
+  // This MUST be placed at the end, see: https://developercommunity.visualstudio.com/t/msvc::no_unique_address-leads-to-ext/10898323
+  YK_NO_UNIQUE_ADDRESS allocator_type alloc_{};
+};
+
+}  // namespace yk::detail
+
+#endif  // YK_DETAIL_RAW_HASH_TABLE_HPP
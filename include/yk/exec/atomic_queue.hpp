@@ -4,6 +4,7 @@
 #include "yk/exec/queue_traits.hpp"
 
 #include "yk/arch.hpp"
+#include "yk/enum_bitops.hpp"
 #include "yk/no_unique_address.hpp"
 
 #include <version>
@@ -13,25 +14,70 @@
 #endif
 
 #include <algorithm> // min, max
+#include <concepts>
+#include <functional>
 #include <utility>
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
 
+#include <numeric> // gcd
 #include <cstddef>
 
+namespace yk::exec {
+
+// Memory layout of the slots of atomic_queue.
+//
+//   padded : each slot occupies its own cache line(s); no false sharing at all
+//   compact: slots are packed without padding, and consecutive tickets are scattered
+//            across cache lines by an index permutation, so that sequential producers
+//            (or consumers) still touch different lines. Trades some false sharing
+//            under heavy contention for a much smaller footprint with small T.
+enum class atomic_queue_layout
+{
+  padded,
+  compact,
+};
+
+enum struct atomic_queue_flag : unsigned
+{
+  // close() makes producers fail, while consumers drain the remaining values;
+  // the blocking operations return false instead of relying on a stop_token
+  closable = 0b1,
+};
+
+} // yk::exec
+
+
+namespace yk {
+
+template <>
+struct bitops_enabled<::yk::exec::atomic_queue_flag> : std::true_type {};
+
+} // yk
+
+
 namespace yk::exec {
 
 namespace detail {
 
-template <class T, class Alloc>
+template <atomic_queue_layout Layout>
+inline constexpr std::size_t atomic_queue_turn_align =
+  Layout == atomic_queue_layout::compact ? alignof(std::atomic<std::size_t>) : yk::hardware_destructive_interference_size;
+
+template <class T, class Alloc, atomic_queue_layout Layout = atomic_queue_layout::padded>
 struct atomic_queue_slot
 {
   explicit atomic_queue_slot(const Alloc& allocator = {}) noexcept
     : allocator_(allocator)
   {
-    if constexpr (alignof(T) < yk::hardware_destructive_interference_size) {
+    if constexpr (Layout == atomic_queue_layout::compact) {
+      constexpr std::size_t storage_ofs = std::max(alignof(T), sizeof(turn));
+      static_assert(offsetof(atomic_queue_slot, storage) == storage_ofs);
+
+    } else if constexpr (alignof(T) < yk::hardware_destructive_interference_size) {
       constexpr std::size_t storage_ofs = std::max(alignof(T), sizeof(turn));
       static_assert(offsetof(atomic_queue_slot, storage) == storage_ofs);
 
@@ -87,8 +133,14 @@ struct atomic_queue_slot
     return static_cast<T&&>(*std::launder(reinterpret_cast<T*>(&storage)));
   }
 
+  [[nodiscard]]
+  T& get() noexcept
+  {
+    return *std::launder(reinterpret_cast<T*>(&storage));
+  }
+
 YK_FORCEALIGN_BEGIN
-  alignas(yk::hardware_destructive_interference_size) std::atomic<std::size_t> turn = 0;
+  alignas(atomic_queue_turn_align<Layout>) std::atomic<std::size_t> turn = 0;
 
   // Permit adjacent placement if alignas(T) is smaller than alignof(turn).
   // Our benchmark show this does not degrade the performance.
@@ -99,12 +151,29 @@ YK_FORCEALIGN_END
   YK_NO_UNIQUE_ADDRESS Alloc allocator_;
 };
 
+// Stride of the index permutation `i -> (i * stride) % capacity` used by the compact layout.
+// The smallest value which is coprime to the capacity (so that the map is a bijection)
+// and at least the number of slots per cache line (so that neighbors land on different lines).
+template <class SlotT>
+[[nodiscard]]
+constexpr std::size_t atomic_queue_remap_stride(const std::size_t capacity) noexcept
+{
+  constexpr std::size_t slots_per_line = std::max<std::size_t>(1, yk::hardware_destructive_interference_size / sizeof(SlotT));
+  if (capacity <= slots_per_line) return 1;
+
+  std::size_t stride = slots_per_line;
+  while (std::gcd(stride, capacity) != 1) ++stride;
+  return stride;
+}
 
-template <class T, class Alloc>
+
+template <class T, class Alloc, atomic_queue_layout Layout = atomic_queue_layout::padded>
 struct atomic_queue_store_dynamic
 {
+public:
+  using slot_type = atomic_queue_slot<T, Alloc, Layout>;
+
 private:
-  using slot_type = atomic_queue_slot<T, Alloc>;
   using slot_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<slot_type>;
 
 public:
@@ -114,9 +183,10 @@ public:
 
   explicit atomic_queue_store_dynamic(const size_type capacity, const Alloc& allocator = {})
     : capacity_(capacity)
+    , stride_(atomic_queue_remap_stride<slot_type>(capacity))
     , slot_allocator_(allocator)
   {
-    static_assert(sizeof(atomic_queue_store_dynamic) == sizeof(capacity_) + sizeof(slots_));
+    static_assert(sizeof(atomic_queue_store_dynamic) == sizeof(capacity_) + sizeof(stride_) + sizeof(slots_));
 
     if (capacity_ < 1) {
       throw std::bad_alloc{};
@@ -149,23 +219,33 @@ public:
   [[nodiscard]]
   slot_type& slot_at(std::size_t i) noexcept
   {
-    return slots_[i];
+    if constexpr (Layout == atomic_queue_layout::compact) {
+      return slots_[i * stride_ % capacity_];
+    } else {
+      return slots_[i];
+    }
   }
 
 private:
   size_type capacity_;
+  size_type stride_;
   slot_type* slots_;
 
   // This MUST be placed at the end, see: https://developercommunity.visualstudio.com/t/msvc::no_unique_address-leads-to-ext/10898323
   YK_NO_UNIQUE_ADDRESS slot_allocator_type slot_allocator_;
 };
 
-template <class T, std::size_t N, class Alloc>
+template <class T, std::size_t N, class Alloc, atomic_queue_layout Layout = atomic_queue_layout::padded>
 struct atomic_queue_store_static
 {
-private:
   static_assert(N >= 1);
-  using slot_type = atomic_queue_slot<T, Alloc>;
+
+public:
+  using slot_type = atomic_queue_slot<T, Alloc, Layout>;
+
+private:
+  static constexpr std::size_t stride = atomic_queue_remap_stride<slot_type>(N);
+
   using slot_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<slot_type>;
 
 public:
@@ -218,6 +298,9 @@ public:
   [[nodiscard]]
   slot_type& slot_at(std::size_t i) noexcept
   {
+    if constexpr (Layout == atomic_queue_layout::compact) {
+      i = i * stride % N;
+    }
     return *std::launder(reinterpret_cast<slot_type*>(&slots_[sizeof(slot_type) * i]));
   }
 
@@ -230,16 +313,35 @@ YK_FORCEALIGN_END
   YK_NO_UNIQUE_ADDRESS slot_allocator_type slot_allocator_;
 };
 
-template <class StoreT, class T, class Alloc>
+template <class StoreT, class T, class Alloc, atomic_queue_flag Flags = {}>
 class atomic_queue_impl
 {
   using store_type = StoreT;
+  using slot_type = typename StoreT::slot_type;
+
+  // set on head_ by close(); no ticket ever reaches this bit
+  static constexpr std::size_t closed_bit = std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 1);
+
+  // destroys the value and hands the slot over to the next producer, even if the visitor throws
+  struct consume_guard
+  {
+    slot_type& slot;
+    std::size_t next_turn;
+
+    ~consume_guard()
+    {
+      slot.destroy();
+      slot.turn.store(next_turn, std::memory_order_release);
+    }
+  };
 
 public:
   using value_type = T;
   using allocator_type = Alloc;
   using size_type = std::size_t;
 
+  static constexpr bool is_closable = contains(Flags, atomic_queue_flag::closable);
+
   explicit atomic_queue_impl(size_type capacity, const Alloc& allocator = {}) /* noexcept */
     : store_(capacity, allocator)
   {}
@@ -258,6 +360,7 @@ public:
   // --------------------------------
 
   template <class... Args>
+    requires (!is_closable)
   void push(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
   {
     const auto head = head_.fetch_add(1);
@@ -276,6 +379,10 @@ public:
     auto head = head_.load(std::memory_order_acquire);
 
     while (true) {
+      if constexpr (is_closable) {
+        if (head & closed_bit) return false;
+      }
+
       auto& slot = store_.slot_at(idx(head));
 
       if (turn(head) * 2 == slot.turn.load(std::memory_order_acquire)) {
@@ -294,6 +401,7 @@ public:
   }
 
   void pop(T& v) noexcept(std::is_nothrow_destructible_v<T>)
+    requires (!is_closable)
   {
     const auto tail = tail_.fetch_add(1);
     auto& slot = store_.slot_at(idx(tail));
@@ -329,13 +437,183 @@ public:
     }
   }
 
+  // --------------------------------
+
+  // Invokes f(T&) on the value in place, then destroys it; no intermediate move.
+  template <class F>
+    requires (!is_closable) && std::invocable<F, T&>
+  void consume(F&& f) noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_destructible_v<T>)
+  {
+    const auto tail = tail_.fetch_add(1);
+    auto& slot = store_.slot_at(idx(tail));
+
+    while (turn(tail) * 2 + 1 != slot.turn.load(std::memory_order_acquire));
+
+    consume_guard guard{slot, turn(tail) * 2 + 2};
+    std::invoke(std::forward<F>(f), slot.get());
+  }
+
+  template <class F>
+    requires std::invocable<F, T&>
+  [[nodiscard]]
+  bool try_consume(F&& f) noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_destructible_v<T>)
+  {
+    auto tail = tail_.load(std::memory_order_acquire);
+
+    while (true) {
+      auto& slot = store_.slot_at(idx(tail));
+
+      if (turn(tail) * 2 + 1 == slot.turn.load(std::memory_order_acquire)) {
+        if (tail_.compare_exchange_strong(tail, tail + 1)) {
+          consume_guard guard{slot, turn(tail) * 2 + 2};
+          std::invoke(std::forward<F>(f), slot.get());
+          return true;
+        }
+
+      } else {
+        const auto prev_tail = tail;
+        tail = tail_.load(std::memory_order_acquire);
+        if (tail == prev_tail) return false;
+      }
+    }
+  }
+
+  // Default-constructs the value in place, then lets f(T&) fill it.
+  // f must not throw; a claimed slot has to be published.
+  template <class F>
+    requires (!is_closable) && std::default_initializable<T> && std::is_nothrow_invocable_v<F, T&>
+  void produce(F&& f) noexcept(std::is_nothrow_default_constructible_v<T>)
+  {
+    const auto head = head_.fetch_add(1);
+    auto& slot = store_.slot_at(idx(head));
+
+    while (turn(head) * 2 != slot.turn.load(std::memory_order_acquire));
+
+    slot.construct();
+    std::invoke(std::forward<F>(f), slot.get());
+    slot.turn.store(turn(head) * 2 + 1, std::memory_order_release);
+  }
+
+  template <class F>
+    requires std::default_initializable<T> && std::is_nothrow_invocable_v<F, T&>
+  [[nodiscard]]
+  bool try_produce(F&& f) noexcept(std::is_nothrow_default_constructible_v<T>)
+  {
+    auto head = head_.load(std::memory_order_acquire);
+
+    while (true) {
+      if constexpr (is_closable) {
+        if (head & closed_bit) return false;
+      }
+
+      auto& slot = store_.slot_at(idx(head));
+
+      if (turn(head) * 2 == slot.turn.load(std::memory_order_acquire)) {
+        if (head_.compare_exchange_strong(head, head + 1)) {
+          slot.construct();
+          std::invoke(std::forward<F>(f), slot.get());
+          slot.turn.store(turn(head) * 2 + 1, std::memory_order_release);
+          return true;
+        }
+
+      } else {
+        const auto prev_head = head;
+        head = head_.load(std::memory_order_acquire);
+        if (head == prev_head) return false;
+      }
+    }
+  }
+
+  // --------------------------------
+
+  // returns false if the queue is closed
+  template <class... Args>
+  [[nodiscard]]
+  bool push_wait(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    requires is_closable
+  {
+    while (!is_closed()) {
+      if (try_push(std::forward<Args>(args)...)) return true; // args are consumed only on success
+    }
+    return false;
+  }
+
+  // returns false once the queue is closed and every value pushed before has been popped
+  [[nodiscard]]
+  bool pop_wait(T& v) noexcept(std::is_nothrow_destructible_v<T>)
+    requires is_closable
+  {
+    while (true) {
+      if (try_pop(v)) return true;
+      if (is_drained()) return false;
+    }
+  }
+
+  template <class F>
+    requires is_closable && std::default_initializable<T> && std::is_nothrow_invocable_v<F, T&>
+  [[nodiscard]]
+  bool produce_wait(F&& f) noexcept(std::is_nothrow_default_constructible_v<T>)
+  {
+    while (!is_closed()) {
+      if (try_produce(f)) return true;
+    }
+    return false;
+  }
+
+  template <class F>
+    requires is_closable && std::invocable<F, T&>
+  [[nodiscard]]
+  bool consume_wait(F&& f) noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_destructible_v<T>)
+  {
+    while (true) {
+      if (try_consume(f)) return true;
+      if (is_drained()) return false;
+    }
+  }
+
+  // thread-safe
+  // producers fail from now on; consumers keep popping until the queue is drained
+  void close() noexcept requires is_closable
+  {
+    head_.fetch_or(closed_bit, std::memory_order_acq_rel);
+  }
+
+  // thread-safe
+  void open() noexcept requires is_closable
+  {
+    head_.fetch_and(~closed_bit, std::memory_order_acq_rel);
+  }
+
+  [[nodiscard]]
+  bool is_closed() const noexcept requires is_closable
+  {
+    return head_.load(std::memory_order_acquire) & closed_bit;
+  }
+
+  // closed, and every value pushed before close() has been claimed by a consumer
+  [[nodiscard]]
+  bool is_drained() const noexcept requires is_closable
+  {
+    const auto head = head_.load(std::memory_order_acquire);
+    return (head & closed_bit) && tail_.load(std::memory_order_acquire) >= (head & ~closed_bit);
+  }
+
+  // thread-safe
+  // destroys the values currently in the queue
+  void clear() noexcept(std::is_nothrow_destructible_v<T>)
+  {
+    while (try_consume([](T&) noexcept {}));
+  }
+
+  // --------------------------------
+
   [[nodiscard]]
   size_type capacity() const noexcept { return store_.capacity(); }
 
   [[nodiscard]]
   size_type size() const noexcept
   {
-    const auto diff = static_cast<std::ptrdiff_t>(head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed));
+    const auto diff = static_cast<std::ptrdiff_t>((head_.load(std::memory_order_relaxed) & ~closed_bit) - tail_.load(std::memory_order_relaxed));
     return static_cast<size_type>(diff < 0 ? -diff : diff);
   }
 
@@ -355,36 +633,50 @@ YK_FORCEALIGN_END
 } // detail
 
 
-template <class T, class Alloc = std::allocator<T>>
-class atomic_queue : public detail::atomic_queue_impl<detail::atomic_queue_store_dynamic<T, Alloc>, T, Alloc>
+template <class T, class Alloc = std::allocator<T>, atomic_queue_layout Layout = atomic_queue_layout::padded, atomic_queue_flag Flags = {}>
+class atomic_queue : public detail::atomic_queue_impl<detail::atomic_queue_store_dynamic<T, Alloc, Layout>, T, Alloc, Flags>
 {
 public:
   using atomic_queue::atomic_queue_impl::atomic_queue_impl;
 };
 
-template <class T, std::size_t N, class Alloc = std::allocator<T>>
-class static_atomic_queue : public detail::atomic_queue_impl<detail::atomic_queue_store_static<T, N, Alloc>, T, Alloc>
+template <class T, std::size_t N, class Alloc = std::allocator<T>, atomic_queue_layout Layout = atomic_queue_layout::padded, atomic_queue_flag Flags = {}>
+class static_atomic_queue : public detail::atomic_queue_impl<detail::atomic_queue_store_static<T, N, Alloc, Layout>, T, Alloc, Flags>
 {
 public:
   using static_atomic_queue::atomic_queue_impl::atomic_queue_impl;
 };
 
+template <class T, class Alloc = std::allocator<T>>
+using compact_atomic_queue = atomic_queue<T, Alloc, atomic_queue_layout::compact>;
+
+template <class T, std::size_t N, class Alloc = std::allocator<T>>
+using compact_static_atomic_queue = static_atomic_queue<T, N, Alloc, atomic_queue_layout::compact>;
+
+template <class T, class Alloc = std::allocator<T>>
+using closable_atomic_queue = atomic_queue<T, Alloc, atomic_queue_layout::padded, atomic_queue_flag::closable>;
+
+template <class T, std::size_t N, class Alloc = std::allocator<T>>
+using closable_static_atomic_queue = static_atomic_queue<T, N, Alloc, atomic_queue_layout::padded, atomic_queue_flag::closable>;
+
 
 // ------------------------------------------
 
-#if __cpp_lib_jthread >= 201911L
+namespace detail {
 
-template <class T, class Alloc>
-struct queue_traits<atomic_queue<T, Alloc>>
+template <class QueueT>
+struct atomic_queue_common_traits
 {
-  using queue_type = atomic_queue<T, Alloc>;
-  using value_type = T;
+  using queue_type = QueueT;
+  using value_type = typename QueueT::value_type;
 
-  static constexpr bool need_stop_token_for_cancel = true;
+  static constexpr bool need_stop_token_for_cancel = !QueueT::is_closable;
 
+#if __cpp_lib_jthread >= 201911L
   template <class... Args>
   [[nodiscard]]
   static bool cancelable_bounded_push(std::stop_token const& stop_token, queue_type& queue, Args&&... args)
+    requires (!QueueT::is_closable)
   {
     while (!stop_token.stop_requested()) {
       if (queue.try_push(std::forward<Args>(args)...)) return true;
@@ -393,44 +685,81 @@ struct queue_traits<atomic_queue<T, Alloc>>
   }
 
   [[nodiscard]]
-  static bool cancelable_pop(std::stop_token const& stop_token, queue_type& queue, T& value)
+  static bool cancelable_pop(std::stop_token const& stop_token, queue_type& queue, value_type& value)
+    requires (!QueueT::is_closable)
   {
     while (!stop_token.stop_requested()) {
       if (queue.try_pop(value)) return true;
     }
     return false;
   }
-};
 
-template <class T, std::size_t N, class Alloc>
-struct queue_traits<static_atomic_queue<T, N, Alloc>>
-{
-  using queue_type = static_atomic_queue<T, N, Alloc>;
-  using value_type = T;
-
-  static constexpr bool need_stop_token_for_cancel = true;
-
-  template <class... Args>
+  template <class F>
   [[nodiscard]]
-  static bool cancelable_bounded_push(std::stop_token const& stop_token, queue_type& queue, Args&&... args)
+  static bool cancelable_push_visit(std::stop_token const& stop_token, queue_type& queue, F&& f)
+    requires (!QueueT::is_closable)
   {
     while (!stop_token.stop_requested()) {
-      if (queue.try_push(std::forward<Args>(args)...)) return true;
+      if (queue.try_produce(f)) return true;
     }
     return false;
   }
 
+  template <class F>
   [[nodiscard]]
-  static bool cancelable_pop(std::stop_token const& stop_token, queue_type& queue, T& value)
+  static bool cancelable_pop_visit(std::stop_token const& stop_token, queue_type& queue, F&& f)
+    requires (!QueueT::is_closable)
   {
     while (!stop_token.stop_requested()) {
-      if (queue.try_pop(value)) return true;
+      if (queue.try_consume(f)) return true;
     }
     return false;
   }
+#endif // stop_token
+
+  template <class... Args>
+  [[nodiscard]]
+  static bool cancelable_bounded_push(queue_type& queue, Args&&... args)
+    requires QueueT::is_closable
+  {
+    return queue.push_wait(std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]]
+  static bool cancelable_pop(queue_type& queue, value_type& value)
+    requires QueueT::is_closable
+  {
+    return queue.pop_wait(value);
+  }
+
+  template <class F>
+  [[nodiscard]]
+  static bool cancelable_push_visit(queue_type& queue, F&& f)
+    requires QueueT::is_closable
+  {
+    return queue.produce_wait(std::forward<F>(f));
+  }
+
+  template <class F>
+  [[nodiscard]]
+  static bool cancelable_pop_visit(queue_type& queue, F&& f)
+    requires QueueT::is_closable
+  {
+    return queue.consume_wait(std::forward<F>(f));
+  }
 };
 
-#endif // stop_token
+} // detail
+
+template <class T, class Alloc, atomic_queue_layout Layout, atomic_queue_flag Flags>
+struct queue_traits<atomic_queue<T, Alloc, Layout, Flags>>
+  : detail::atomic_queue_common_traits<atomic_queue<T, Alloc, Layout, Flags>>
+{};
+
+template <class T, std::size_t N, class Alloc, atomic_queue_layout Layout, atomic_queue_flag Flags>
+struct queue_traits<static_atomic_queue<T, N, Alloc, Layout, Flags>>
+  : detail::atomic_queue_common_traits<static_atomic_queue<T, N, Alloc, Layout, Flags>>
+{};
 
 } // yk::exec
 
@@ -388,6 +388,20 @@ public:
   }
 #endif
 
+  // returns false if the queue is full or closed
+  template <class... Args>
+  [[nodiscard]]
+  bool try_push(Args&&... args)
+  {
+    std::unique_lock lock{mtx_};
+    if (closed_ || static_cast<size_type>(buf_.size()) >= capacity_) {
+      return false;
+    }
+
+    traits_type::push(buf_, cv_not_empty_, std::forward<Args>(args)...);
+    return true;
+  }
+
   // -------------------------------------------
 
   [[nodiscard]]
@@ -436,6 +450,24 @@ public:
   }
 #endif
 
+  // returns false if the queue is empty or closed
+  [[nodiscard]]
+  bool try_pop(T& value)
+  {
+    std::unique_lock lock{mtx_};
+    if (closed_ || buf_.empty()) {
+      return false;
+    }
+
+    if constexpr (traits_type::is_single_producer && traits_type::is_single_consumer) {
+      traits_type::pop(buf_, cv_not_full_, capacity_, value);
+
+    } else {
+      traits_type::pop(buf_, cv_not_full_, value);
+    }
+    return true;
+  }
+
   // -------------------------------------------
 
   void close()
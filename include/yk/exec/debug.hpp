@@ -9,6 +9,12 @@
 #endif
 #endif
 
+// per-worker busy/queue/blocked/switch time accounting, required by scheduler scaling policies;
+// off by default since it times every queue gate operation (two clock reads per push/pop)
+#if !defined(YK_EXEC_WORKER_STATS)
+#define YK_EXEC_WORKER_STATS 0
+#endif
+
 #if !defined(YK_EXEC_DEBUG_PRINT)
 #if defined(YK_EXEC_DEBUG)
 #define YK_EXEC_DEBUG_PRINT(...) __VA_ARGS__
@@ -0,0 +1,91 @@
+#ifndef YK_EXEC_EVENTCOUNT_HPP
+#define YK_EXEC_EVENTCOUNT_HPP
+
+#include "yk/exec/debug.hpp" // for ODR violation safety
+
+#include "yk/arch.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace yk::exec {
+
+// Lets threads block on an arbitrary condition of a lock-free structure, without a mutex.
+//
+// Waiter:
+//   while (!try_something()) {
+//     const auto key = ec.prepare_wait();
+//     if (try_something()) { ec.cancel_wait(); break; } // re-check after announcing ourselves
+//     ec.wait(key);
+//   }
+//
+// Notifier:
+//   make_something_available();
+//   ec.notify_one(); // a fence and a load if nobody is waiting
+class eventcount
+{
+public:
+  using key_type = std::uint32_t;
+
+  eventcount() noexcept = default;
+  eventcount(const eventcount&) = delete;
+  eventcount& operator=(const eventcount&) = delete;
+
+  // thread-safe
+  [[nodiscard]]
+  key_type prepare_wait() noexcept
+  {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  // thread-safe
+  void cancel_wait() noexcept
+  {
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // thread-safe
+  // returns immediately if any notification happened after prepare_wait()
+  void wait(key_type key) noexcept
+  {
+    epoch_.wait(key, std::memory_order_seq_cst);
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // thread-safe
+  void notify_one() noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) return;
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_one();
+  }
+
+  // thread-safe
+  void notify_all() noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) return;
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_all();
+  }
+
+  // Note: this holds only the current state.
+  [[nodiscard]]
+  std::uint32_t waiter_count() const noexcept
+  {
+    return waiters_.load(std::memory_order_relaxed);
+  }
+
+private:
+YK_FORCEALIGN_BEGIN
+  alignas(yk::hardware_destructive_interference_size) std::atomic<key_type> epoch_ = 0;
+  std::atomic<std::uint32_t> waiters_ = 0;
+YK_FORCEALIGN_END
+};
+
+} // yk::exec
+
+#endif
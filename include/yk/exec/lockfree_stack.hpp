@@ -0,0 +1,265 @@
+#ifndef YK_EXEC_LOCKFREE_STACK_HPP
+#define YK_EXEC_LOCKFREE_STACK_HPP
+
+#include "yk/exec/eventcount.hpp"
+#include "yk/exec/queue_traits.hpp"
+
+#include "yk/arch.hpp"
+#include "yk/throwt.hpp"
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace yk::exec {
+
+// Bounded lock-free LIFO (Treiber stack), a drop-in for mpmc_cv_vector.
+//
+// Nodes live in a fixed array and are linked by index; the two list heads
+// (values and free nodes) carry a tag that is bumped on every update to rule out ABA.
+// Blocking operations park on an eventcount, so the non-blocking fast path
+// never takes a lock and notification costs nothing while nobody waits.
+//
+// close() has the same semantics as cv_queue::close(): every operation fails
+// and the blocked threads return false until open() is called.
+template <class T>
+class lockfree_stack
+{
+  using index_type = std::uint32_t;
+  static constexpr index_type nil = std::numeric_limits<index_type>::max();
+
+  struct node
+  {
+    std::atomic<index_type> next = nil;
+    alignas(T) std::byte storage[sizeof(T)];
+
+    [[nodiscard]]
+    T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(&storage)); }
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  explicit lockfree_stack(size_type capacity)
+    : capacity_(capacity)
+  {
+    if (capacity_ < 1 || capacity_ >= nil) {
+      throwt<std::invalid_argument>("lockfree_stack capacity must be in [1, {})", nil);
+    }
+    nodes_ = std::make_unique<node[]>(capacity_);
+
+    for (size_type i = 0; i + 1 < capacity_; ++i) {
+      nodes_[i].next.store(static_cast<index_type>(i + 1), std::memory_order_relaxed);
+    }
+    free_head_.store(pack(0, 0), std::memory_order_relaxed);
+  }
+
+  lockfree_stack(const lockfree_stack&) = delete;
+  lockfree_stack(lockfree_stack&&) = delete;
+  lockfree_stack& operator=(const lockfree_stack&) = delete;
+  lockfree_stack& operator=(lockfree_stack&&) = delete;
+
+  ~lockfree_stack()
+  {
+    for (index_type i = index_of(head_.load(std::memory_order_acquire)); i != nil; i = nodes_[i].next.load(std::memory_order_relaxed)) {
+      std::destroy_at(nodes_[i].ptr());
+    }
+  }
+
+  // --------------------------------
+
+  // returns false if the stack is full or closed
+  template <class... Args>
+  [[nodiscard]]
+  bool try_push(Args&&... args)
+  {
+    if (closed_.load(std::memory_order_acquire)) return false;
+
+    const index_type i = pop_list(free_head_);
+    if (i == nil) return false;
+
+    try {
+      ::new (static_cast<void*>(&nodes_[i].storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      push_list(free_head_, i);
+      throw;
+    }
+    push_list(head_, i);
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // returns false if the stack is empty or closed
+  [[nodiscard]]
+  bool try_pop(T& value)
+  {
+    if (closed_.load(std::memory_order_acquire)) return false;
+
+    const index_type i = pop_list(head_);
+    if (i == nil) return false;
+
+    T* ptr = nodes_[i].ptr();
+    try {
+      value = std::move(*ptr);
+    } catch (...) {
+      // the value stays on the stack
+      push_list(head_, i);
+      not_empty_.notify_one();
+      throw;
+    }
+    std::destroy_at(ptr);
+
+    push_list(free_head_, i);
+    not_full_.notify_one();
+    return true;
+  }
+
+  // returns false if the stack is closed
+  template <class... Args>
+  [[nodiscard]]
+  bool push_wait(Args&&... args)
+  {
+    while (true) {
+      if (try_push(std::forward<Args>(args)...)) return true; // args are consumed only on success
+      if (closed_.load(std::memory_order_acquire)) return false;
+
+      const auto key = not_full_.prepare_wait();
+      if (closed_.load(std::memory_order_acquire) || index_of(free_head_.load(std::memory_order_acquire)) != nil) {
+        not_full_.cancel_wait();
+        continue;
+      }
+      not_full_.wait(key);
+    }
+  }
+
+  // returns false if the stack is closed
+  [[nodiscard]]
+  bool pop_wait(T& value)
+  {
+    while (true) {
+      if (try_pop(value)) return true;
+      if (closed_.load(std::memory_order_acquire)) return false;
+
+      const auto key = not_empty_.prepare_wait();
+      if (closed_.load(std::memory_order_acquire) || index_of(head_.load(std::memory_order_acquire)) != nil) {
+        not_empty_.cancel_wait();
+        continue;
+      }
+      not_empty_.wait(key);
+    }
+  }
+
+  // --------------------------------
+
+  // thread-safe
+  void close() noexcept
+  {
+    closed_.store(true, std::memory_order_release);
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  // thread-safe
+  void open() noexcept
+  {
+    closed_.store(false, std::memory_order_release);
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  [[nodiscard]]
+  bool is_closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+  [[nodiscard]]
+  size_type capacity() const noexcept { return capacity_; }
+
+  // Note: this holds only the current state.
+  [[nodiscard]]
+  size_type size() const noexcept
+  {
+    const auto n = size_.load(std::memory_order_relaxed);
+    return n < 0 ? 0 : static_cast<size_type>(n);
+  }
+
+private:
+  // [tag:32][index:32]
+  [[nodiscard]] static constexpr std::uint64_t pack(std::uint64_t tag, index_type i) noexcept { return (tag << 32) | i; }
+  [[nodiscard]] static constexpr index_type index_of(std::uint64_t head) noexcept { return static_cast<index_type>(head); }
+  [[nodiscard]] static constexpr std::uint64_t tag_of(std::uint64_t head) noexcept { return head >> 32; }
+
+  [[nodiscard]]
+  index_type pop_list(std::atomic<std::uint64_t>& head) noexcept
+  {
+    auto old_head = head.load(std::memory_order_acquire);
+    while (true) {
+      const index_type i = index_of(old_head);
+      if (i == nil) return nil;
+
+      // the node may be reused concurrently; then the tag has moved on and the CAS fails
+      const index_type next = nodes_[i].next.load(std::memory_order_relaxed);
+      if (head.compare_exchange_weak(old_head, pack(tag_of(old_head) + 1, next), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        if (&head == &head_) size_.fetch_sub(1, std::memory_order_relaxed);
+        return i;
+      }
+    }
+  }
+
+  void push_list(std::atomic<std::uint64_t>& head, index_type i) noexcept
+  {
+    if (&head == &head_) size_.fetch_add(1, std::memory_order_relaxed);
+
+    auto old_head = head.load(std::memory_order_relaxed);
+    do {
+      nodes_[i].next.store(index_of(old_head), std::memory_order_relaxed);
+    } while (!head.compare_exchange_weak(old_head, pack(tag_of(old_head) + 1, i), std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  size_type capacity_;
+  std::unique_ptr<node[]> nodes_;
+
+YK_FORCEALIGN_BEGIN
+  alignas(yk::hardware_destructive_interference_size) std::atomic<std::uint64_t> head_ = pack(0, nil);
+  alignas(yk::hardware_destructive_interference_size) std::atomic<std::uint64_t> free_head_ = pack(0, nil);
+  alignas(yk::hardware_destructive_interference_size) std::atomic<std::ptrdiff_t> size_ = 0;
+  std::atomic<bool> closed_ = false;
+
+  eventcount not_empty_;
+  eventcount not_full_;
+YK_FORCEALIGN_END
+};
+
+
+template <class T>
+struct queue_traits<lockfree_stack<T>>
+{
+  using queue_type = lockfree_stack<T>;
+  using value_type = T;
+
+  static constexpr bool need_stop_token_for_cancel = false;
+
+  template <class... Args>
+  [[nodiscard]]
+  static bool cancelable_bounded_push(queue_type& queue, Args&&... args)
+  {
+    return queue.push_wait(std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]]
+  static bool cancelable_pop(queue_type& queue, value_type& value)
+  {
+    return queue.pop_wait(value);
+  }
+};
+
+} // yk::exec
+
+#endif
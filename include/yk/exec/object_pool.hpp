@@ -0,0 +1,176 @@
+#ifndef YK_EXEC_OBJECT_POOL_HPP
+#define YK_EXEC_OBJECT_POOL_HPP
+
+#include "yk/exec/atomic_queue.hpp"
+#include "yk/exec/eventcount.hpp"
+
+#include "yk/throwt.hpp"
+
+#include <concepts>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+#include <cstddef>
+
+
+namespace yk::exec {
+
+// Fixed set of objects recycled between consumers and producers.
+//
+// A producer acquire()s a pre-built object (e.g. a vector with reserved capacity),
+// fills it, and pushes the handle through the queue; the object goes back to the pool
+// when the consumer drops the handle. The objects are never destroyed before the pool,
+// so the steady state does not allocate, and `capacity` bounds the memory in flight.
+//
+// Objects are returned as-is; clear() them (keeping the capacity) before reuse as needed.
+// The pool must outlive every handle.
+//
+// In a scheduler's producer, acquire with the worker pool's stop_token() so that
+// abort() and drain() can cancel a producer waiting for the consumers to return objects.
+template <class T>
+class object_pool
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  // Move-only owner of one pooled object; an empty handle owns nothing.
+  class handle
+  {
+  public:
+    handle() noexcept = default;
+
+    handle(handle&& other) noexcept
+      : pool_(std::exchange(other.pool_, nullptr))
+      , obj_(std::exchange(other.obj_, nullptr))
+    {}
+
+    handle& operator=(handle&& other) noexcept
+    {
+      if (this != &other) {
+        reset();
+        pool_ = std::exchange(other.pool_, nullptr);
+        obj_ = std::exchange(other.obj_, nullptr);
+      }
+      return *this;
+    }
+
+    ~handle() { reset(); }
+
+    // returns the object to the pool
+    void reset() noexcept
+    {
+      if (!obj_) return;
+      pool_->release(std::exchange(obj_, nullptr));
+      pool_ = nullptr;
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept { return obj_ != nullptr; }
+
+    [[nodiscard]] T* get() const noexcept { return obj_; }
+    [[nodiscard]] T& operator*() const noexcept { return *obj_; }
+    [[nodiscard]] T* operator->() const noexcept { return obj_; }
+
+  private:
+    friend class object_pool;
+
+    handle(object_pool* pool, T* obj) noexcept
+      : pool_(pool)
+      , obj_(obj)
+    {}
+
+    object_pool* pool_ = nullptr;
+    T* obj_ = nullptr;
+  };
+
+  // constructs `capacity` objects, each with the same arguments
+  template <class... Args>
+    requires std::constructible_from<T, const Args&...>
+  explicit object_pool(size_type capacity, const Args&... args)
+    : free_(capacity)
+  {
+    if (capacity < 1) {
+      throwt<std::invalid_argument>("object_pool capacity must be >= 1");
+    }
+    for (size_type i = 0; i < capacity; ++i) {
+      T& obj = objects_.emplace_back(args...);
+      free_.push(&obj);
+    }
+  }
+
+  object_pool(const object_pool&) = delete;
+  object_pool(object_pool&&) = delete;
+  object_pool& operator=(const object_pool&) = delete;
+  object_pool& operator=(object_pool&&) = delete;
+
+  // --------------------------------
+
+  // thread-safe
+  // returns an empty handle if every object is in use
+  [[nodiscard]]
+  handle try_acquire() noexcept
+  {
+    T* obj = nullptr;
+    if (!free_.try_pop(obj)) return {};
+    return {this, obj};
+  }
+
+  // thread-safe
+  // blocks until an object is returned
+  [[nodiscard]]
+  handle acquire() noexcept
+  {
+    return acquire(std::stop_token{});
+  }
+
+  // thread-safe
+  // blocks until an object is returned; returns an empty handle once stop is requested
+  [[nodiscard]]
+  handle acquire(std::stop_token stop_token) noexcept
+  {
+    T* obj = nullptr;
+    if (free_.try_pop(obj)) return {this, obj};
+
+    std::stop_callback wake{stop_token, [this]() noexcept { returned_.notify_all(); }};
+    while (true) {
+      const auto key = returned_.prepare_wait();
+      if (free_.try_pop(obj)) {
+        returned_.cancel_wait();
+        return {this, obj};
+      }
+      if (stop_token.stop_requested()) {
+        returned_.cancel_wait();
+        return {};
+      }
+      returned_.wait(key);
+    }
+  }
+
+  // --------------------------------
+
+  [[nodiscard]]
+  size_type capacity() const noexcept { return objects_.size(); }
+
+  // Note: this holds only the current state.
+  [[nodiscard]]
+  size_type available() const noexcept { return free_.size(); }
+
+private:
+  // never blocks: at most `capacity` pointers are ever in flight
+  void release(T* obj) noexcept
+  {
+    free_.push(obj);
+    returned_.notify_one();
+  }
+
+  std::deque<T> objects_; // stable addresses, no move required
+  atomic_queue<T*> free_;
+  eventcount returned_;
+};
+
+} // yk::exec
+
+#endif
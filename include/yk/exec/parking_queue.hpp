@@ -0,0 +1,192 @@
+#ifndef YK_EXEC_PARKING_QUEUE_HPP
+#define YK_EXEC_PARKING_QUEUE_HPP
+
+#include "yk/exec/eventcount.hpp"
+#include "yk/exec/queue_traits.hpp"
+
+#include <version>
+
+#if __cpp_lib_jthread >= 201911L
+#include <stop_token>
+#endif
+
+#include <concepts>
+#include <utility>
+
+#include <cstddef>
+
+
+namespace yk::exec {
+
+namespace detail {
+
+// atomic_queue style (try_push / try_pop) or boost.lockfree style (bounded_push / pop)
+template <class QueueT, class... Args>
+[[nodiscard]]
+bool parking_try_push(QueueT& queue, Args&&... args)
+{
+  if constexpr (requires { { queue.try_push(std::forward<Args>(args)...) } -> std::convertible_to<bool>; }) {
+    return queue.try_push(std::forward<Args>(args)...);
+  } else {
+    return queue.bounded_push(std::forward<Args>(args)...);
+  }
+}
+
+template <class QueueT, class T>
+[[nodiscard]]
+bool parking_try_pop(QueueT& queue, T& value)
+{
+  if constexpr (requires { { queue.try_pop(value) } -> std::convertible_to<bool>; }) {
+    return queue.try_pop(value);
+  } else {
+    return queue.pop(value);
+  }
+}
+
+} // detail
+
+// Wraps a lock-free container so that blocked producers and consumers park
+// instead of spinning. Each side spins `spin_count` times, then sleeps on an
+// eventcount; the other side pays only a fence and a load unless someone is parked.
+//
+// The wrapped container must not be accessed directly while the adaptor is in use,
+// otherwise the notifications are missed.
+template <class QueueT>
+class parking_queue
+{
+public:
+  using queue_type = QueueT;
+  using value_type = typename QueueT::value_type;
+
+  static constexpr int default_spin_count = 64;
+
+  template <class... QueueArgs>
+    requires std::constructible_from<QueueT, QueueArgs...>
+  explicit parking_queue(QueueArgs&&... queue_args)
+    : queue_(std::forward<QueueArgs>(queue_args)...)
+  {}
+
+  parking_queue(const parking_queue&) = delete;
+  parking_queue(parking_queue&&) = delete;
+  parking_queue& operator=(const parking_queue&) = delete;
+  parking_queue& operator=(parking_queue&&) = delete;
+
+  // --------------------------------
+
+  template <class... Args>
+  [[nodiscard]]
+  bool try_push(Args&&... args)
+  {
+    if (!detail::parking_try_push(queue_, std::forward<Args>(args)...)) return false;
+    not_empty_.notify_one();
+    return true;
+  }
+
+  [[nodiscard]]
+  bool try_pop(value_type& value)
+  {
+    if (!detail::parking_try_pop(queue_, value)) return false;
+    not_full_.notify_one();
+    return true;
+  }
+
+#if __cpp_lib_jthread >= 201911L
+  // returns false on stop request
+  template <class... Args>
+  [[nodiscard]]
+  bool push_wait(std::stop_token const& stop_token, Args&&... args)
+  {
+    // args are consumed only on success
+    return wait_until(stop_token, not_full_, [&] { return try_push(std::forward<Args>(args)...); });
+  }
+
+  // returns false on stop request
+  [[nodiscard]]
+  bool pop_wait(std::stop_token const& stop_token, value_type& value)
+  {
+    return wait_until(stop_token, not_empty_, [&] { return try_pop(value); });
+  }
+#endif
+
+  // --------------------------------
+
+  // not thread-safe
+  void set_spin_count(int spin_count) noexcept { spin_count_ = spin_count; }
+
+  [[nodiscard]] int get_spin_count() const noexcept { return spin_count_; }
+
+  // Note: these hold only the current state.
+  [[nodiscard]] std::size_t parked_producers() const noexcept { return not_full_.waiter_count(); }
+  [[nodiscard]] std::size_t parked_consumers() const noexcept { return not_empty_.waiter_count(); }
+
+  [[nodiscard]] queue_type& underlying() noexcept { return queue_; }
+  [[nodiscard]] const queue_type& underlying() const noexcept { return queue_; }
+
+private:
+#if __cpp_lib_jthread >= 201911L
+  template <class TryF>
+  [[nodiscard]]
+  bool wait_until(std::stop_token const& stop_token, eventcount& ec, TryF&& try_f)
+  {
+    for (int i = 0; i < spin_count_; ++i) {
+      if (stop_token.stop_requested()) return false;
+      if (try_f()) return true;
+    }
+
+    // the callback is registered only once we are about to park
+    std::stop_callback on_stop{stop_token, [&ec] { ec.notify_all(); }};
+
+    while (true) {
+      if (stop_token.stop_requested()) return false;
+      if (try_f()) return true;
+
+      const auto key = ec.prepare_wait();
+      if (stop_token.stop_requested()) {
+        ec.cancel_wait();
+        return false;
+      }
+      if (try_f()) {
+        ec.cancel_wait();
+        return true;
+      }
+      ec.wait(key);
+    }
+  }
+#endif
+
+  queue_type queue_;
+  int spin_count_ = default_spin_count;
+
+  eventcount not_empty_;
+  eventcount not_full_;
+};
+
+#if __cpp_lib_jthread >= 201911L
+
+template <class QueueT>
+struct queue_traits<parking_queue<QueueT>>
+{
+  using queue_type = parking_queue<QueueT>;
+  using value_type = typename queue_type::value_type;
+
+  static constexpr bool need_stop_token_for_cancel = true;
+
+  template <class... Args>
+  [[nodiscard]]
+  static bool cancelable_bounded_push(std::stop_token const& stop_token, queue_type& queue, Args&&... args)
+  {
+    return queue.push_wait(stop_token, std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]]
+  static bool cancelable_pop(std::stop_token const& stop_token, queue_type& queue, value_type& value)
+  {
+    return queue.pop_wait(stop_token, value);
+  }
+};
+
+#endif // stop_token
+
+} // yk::exec
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef YK_EXEC_PORT_BOOST_LOCKFREE_SPSC_QUEUE_HPP
+#define YK_EXEC_PORT_BOOST_LOCKFREE_SPSC_QUEUE_HPP
+
+#include "yk/exec/queue_traits.hpp"
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <stop_token>
+#include <utility>
+
+#include <cstddef>
+
+namespace yk::exec {
+
+// Single producer, single consumer only: the scheduler must run with exactly
+// the fixed producer and the fixed consumer (worker_pool::set_worker_limit(2)).
+template <class T, class... Options>
+struct queue_traits<boost::lockfree::spsc_queue<T, Options...>>
+{
+  using queue_type = boost::lockfree::spsc_queue<T, Options...>;
+  using value_type = T;
+
+  static constexpr bool need_stop_token_for_cancel = true;
+  static constexpr bool is_single_producer_single_consumer = true;
+
+  template <class... Args>
+  [[nodiscard]]
+  static bool cancelable_bounded_push(std::stop_token const& stop_token, queue_type& queue, Args&&... args)
+  {
+    while (!stop_token.stop_requested()) {
+      if (queue.push(std::forward<Args>(args)...)) return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]]
+  static bool cancelable_pop(std::stop_token const& stop_token, queue_type& queue, value_type& value)
+  {
+    while (!stop_token.stop_requested()) {
+      if (queue.pop(value)) return true;
+    }
+    return false;
+  }
+
+  // returns the iterator past the last pushed value; `last` unless cancelled
+  template <class Iterator>
+  [[nodiscard]]
+  static Iterator cancelable_push_range(std::stop_token const& stop_token, queue_type& queue, Iterator first, Iterator last)
+  {
+    while (first != last && !stop_token.stop_requested()) {
+      first = queue.push(first, last);
+    }
+    return first;
+  }
+
+  // returns the number of values popped; 0 if cancelled
+  [[nodiscard]]
+  static std::size_t cancelable_pop_bulk(std::stop_token const& stop_token, queue_type& queue, value_type* out, std::size_t max_count)
+  {
+    while (!stop_token.stop_requested()) {
+      if (const auto n = queue.pop(out, max_count)) return n;
+    }
+    return 0;
+  }
+};
+
+} // yk::exec
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef YK_EXEC_PRIORITY_LANE_QUEUE_HPP
+#define YK_EXEC_PRIORITY_LANE_QUEUE_HPP
+
+#include "yk/exec/debug.hpp"// for ODR violation safety
+#include "yk/exec/eventcount.hpp"
+#include "yk/exec/queue_traits.hpp"
+
+#include "yk/arch.hpp"
+#include "yk/throwt.hpp"
+
+#include <version>
+
+#if __cpp_lib_jthread >= 201911L
+#include <stop_token>
+#endif
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <cstddef>
+
+
+namespace yk::exec {
+
+// Lane selector for priority_lane_queue; 0 is the highest priority.
+// Pass it as the first argument of push_wait() on a producer gate.
+struct priority
+{
+  std::size_t level = 0;
+};
+
+template <class QueueT>
+concept PriorityLane = requires(QueueT& queue, typename QueueT::value_type& value) {
+  { queue.try_push(std::move(value)) } -> std::convertible_to<bool>;
+  { queue.try_pop(value) } -> std::convertible_to<bool>;
+};
+
+// N queues of the same type, drained from the highest lane first.
+//
+// To keep the lower lanes from starving, every `starvation_period`-th pop
+// starts scanning from a lower lane (rotating), then wraps around to the top.
+// Items pushed without a priority go to the lowest lane.
+//
+// Blocked producers and consumers (push_wait() / pop_wait()) poll for
+// `spin_count` rounds, yielding in the latter half, then park on an eventcount.
+// Pushing or popping through lane() bypasses the wake-ups, so parked waiters
+// may miss such items until the next push or pop through the queue itself.
+template <class QueueT, std::size_t N>
+class priority_lane_queue
+{
+  static_assert(N >= 1);
+  static_assert(PriorityLane<QueueT>);
+
+public:
+  using lane_type  = QueueT;
+  using value_type = typename QueueT::value_type;
+  using size_type  = std::size_t;
+
+  static constexpr size_type lane_count = N;
+  static constexpr size_type default_priority = N - 1;
+  static constexpr size_type default_starvation_period = 16;
+  static constexpr int default_spin_count = 64;
+
+  // each lane is constructed with the same arguments
+  template <class... LaneArgs>
+    requires std::constructible_from<QueueT, LaneArgs&...>
+  explicit priority_lane_queue(LaneArgs&&... lane_args)
+    : lanes_(make_lanes(std::make_index_sequence<N>{}, lane_args...))
+  {}
+
+  priority_lane_queue(const priority_lane_queue&) = delete;
+  priority_lane_queue(priority_lane_queue&&) = delete;
+  priority_lane_queue& operator=(const priority_lane_queue&) = delete;
+  priority_lane_queue& operator=(priority_lane_queue&&) = delete;
+
+  // --------------------------------
+
+  [[nodiscard]] lane_type& lane(size_type level) noexcept { return lanes_[level]; }
+  [[nodiscard]] const lane_type& lane(size_type level) const noexcept { return lanes_[level]; }
+
+  // not thread-safe
+  void set_starvation_period(size_type period)
+  {
+    if (period < 1) {
+      throwt<std::invalid_argument>("starvation period must be >= 1");
+    }
+    starvation_period_ = period;
+  }
+
+  [[nodiscard]] size_type get_starvation_period() const noexcept { return starvation_period_; }
+
+  // not thread-safe
+  void set_spin_count(int spin_count) noexcept { spin_count_ = spin_count; }
+
+  [[nodiscard]] int get_spin_count() const noexcept { return spin_count_; }
+
+  // --------------------------------
+
+  template <class... Args>
+  [[nodiscard]]
+  bool try_push(priority prio, Args&&... args)
+  {
+    if (prio.level >= N) {
+      throwt<std::out_of_range>("priority level ({}) must be less than the lane count ({})", prio.level, N);
+    }
+    if (!lanes_[prio.level].try_push(std::forward<Args>(args)...)) return false;
+    not_empty_.notify_one();
+    return true;
+  }
+
+  template <class... Args>
+  [[nodiscard]]
+  bool try_push(Args&&... args)
+  {
+    if (!lanes_[default_priority].try_push(std::forward<Args>(args)...)) return false;
+    not_empty_.notify_one();
+    return true;
+  }
+
+  [[nodiscard]]
+  bool try_pop(value_type& value)
+  {
+    if (!try_pop_lanes(value)) return false;
+    not_full_.notify_one();
+    return true;
+  }
+
+#if __cpp_lib_jthread >= 201911L
+  // returns false on stop request
+  template <class... Args>
+  [[nodiscard]]
+  bool push_wait(std::stop_token const& stop_token, priority prio, Args&&... args)
+  {
+    // args are consumed only on success
+    return wait_until(stop_token, not_full_, [&] { return try_push(prio, std::forward<Args>(args)...); });
+  }
+
+  // returns false on stop request
+  template <class... Args>
+  [[nodiscard]]
+  bool push_wait(std::stop_token const& stop_token, Args&&... args)
+  {
+    return wait_until(stop_token, not_full_, [&] { return try_push(std::forward<Args>(args)...); });
+  }
+
+  // returns false on stop request
+  [[nodiscard]]
+  bool pop_wait(std::stop_token const& stop_token, value_type& value)
+  {
+    return wait_until(stop_token, not_empty_, [&] { return try_pop(value); });
+  }
+#endif
+
+  // Note: these hold only the current state.
+  [[nodiscard]] std::size_t parked_producers() const noexcept { return not_full_.waiter_count(); }
+  [[nodiscard]] std::size_t parked_consumers() const noexcept { return not_empty_.waiter_count(); }
+
+  // Note: this holds only the current state.
+  [[nodiscard]]
+  size_type size() const
+  {
+    size_type sum = 0;
+    for (const auto& lane : lanes_) sum += static_cast<size_type>(lane.size());
+    return sum;
+  }
+
+private:
+  [[nodiscard]]
+  bool try_pop_lanes(value_type& value)
+  {
+    size_type first = 0;
+
+    if constexpr (N > 1) {
+      const auto ticket = pop_ticket_.fetch_add(1, std::memory_order_relaxed);
+      if (ticket % starvation_period_ == starvation_period_ - 1) {
+        first = 1 + (ticket / starvation_period_) % (N - 1);
+      }
+    }
+
+    for (size_type i = 0; i < N; ++i) {
+      if (lanes_[(first + i) % N].try_pop(value)) return true;
+    }
+    return false;
+  }
+
+#if __cpp_lib_jthread >= 201911L
+  template <class TryF>
+  [[nodiscard]]
+  bool wait_until(std::stop_token const& stop_token, eventcount& ec, TryF&& try_f)
+  {
+    // every poll scans all lanes (and locks each one for cv_queue lanes),
+    // so back off before parking instead of polling in a tight loop
+    for (int i = 0; i < spin_count_; ++i) {
+      if (stop_token.stop_requested()) return false;
+      if (try_f()) return true;
+      if (i >= spin_count_ / 2) std::this_thread::yield();
+    }
+
+    // the callback is registered only once we are about to park
+    std::stop_callback on_stop{stop_token, [&ec] { ec.notify_all(); }};
+
+    while (true) {
+      if (stop_token.stop_requested()) return false;
+      if (try_f()) return true;
+
+      const auto key = ec.prepare_wait();
+      if (stop_token.stop_requested()) {
+        ec.cancel_wait();
+        return false;
+      }
+      if (try_f()) {
+        ec.cancel_wait();
+        return true;
+      }
+      ec.wait(key);
+    }
+  }
+#endif
+
+  template <std::size_t... Is, class... LaneArgs>
+  static std::array<QueueT, N> make_lanes(std::index_sequence<Is...>, LaneArgs&... lane_args)
+  {
+    return {((void)Is, QueueT(lane_args...))...};
+  }
+
+YK_FORCEALIGN_BEGIN
+  std::array<QueueT, N> lanes_;
+  alignas(yk::hardware_destructive_interference_size) std::atomic<size_type> pop_ticket_ = 0;
+  size_type starvation_period_ = default_starvation_period;
+  int spin_count_ = default_spin_count;
+
+  eventcount not_empty_;
+  eventcount not_full_;
+YK_FORCEALIGN_END
+};
+
+#if __cpp_lib_jthread >= 201911L
+
+template <class QueueT, std::size_t N>
+struct queue_traits<priority_lane_queue<QueueT, N>>
+{
+  using queue_type = priority_lane_queue<QueueT, N>;
+  using value_type = typename queue_type::value_type;
+
+  static constexpr bool need_stop_token_for_cancel = true;
+
+  template <class... Args>
+  [[nodiscard]]
+  static bool cancelable_bounded_push(std::stop_token const& stop_token, queue_type& queue, priority prio, Args&&... args)
+  {
+    return queue.push_wait(stop_token, prio, std::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  [[nodiscard]]
+  static bool cancelable_bounded_push(std::stop_token const& stop_token, queue_type& queue, Args&&... args)
+  {
+    return queue.push_wait(stop_token, std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]]
+  static bool cancelable_pop(std::stop_token const& stop_token, queue_type& queue, value_type& value)
+  {
+    return queue.pop_wait(stop_token, value);
+  }
+};
+
+#endif // stop_token
+
+} // yk::exec
+
+#endif
@@ -10,12 +10,19 @@
 
 #include <boost/assert.hpp>
 
-#if YK_EXEC_DEBUG
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
 #include <chrono>
 #endif
 
 #include <version>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
+
+#include <cstddef>
 
 #if __cpp_lib_jthread >= 201911L
 #include <stop_token>
@@ -121,7 +128,7 @@ struct queue_gate_store_base
 
   // -----------------------------------------
 
-#if YK_EXEC_DEBUG
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
 public:
   [[nodiscard]] std::chrono::nanoseconds elapsed_time() const noexcept { return elapsed_time_; }
 
@@ -194,7 +201,7 @@ public:
   [[nodiscard]]
   bool push_wait(Args&&... args) requires (WorkerMode == worker_mode_t::producer)
   {
-#if YK_EXEC_DEBUG
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
     typename base_type::auto_timer timer{this};
 #endif
 
@@ -212,7 +219,7 @@ public:
   [[nodiscard]]
   bool pop_wait(Args&&... args) requires (WorkerMode == worker_mode_t::consumer)
   {
-#if YK_EXEC_DEBUG
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
     typename base_type::auto_timer timer{this};
 #endif
 
@@ -226,7 +233,142 @@ public:
     }
   }
 
+  // constructs the value in place; see queue_traits for the required traits functions
+  template <class F>
+  [[nodiscard]]
+  bool push_visit(F&& f)
+    requires (WorkerMode == worker_mode_t::producer) && detail::CancelablePushVisit<traits_type, F>
+  {
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
+    typename base_type::auto_timer timer{this};
+#endif
+
+    this->mark_access();
+
+    if constexpr (traits_type::need_stop_token_for_cancel) {
+      return traits_type::cancelable_push_visit(this->stop_token_, *this->queue_, make_visitor(f));
+
+    } else {
+      return traits_type::cancelable_push_visit(*this->queue_, make_visitor(f));
+    }
+  }
+
+  // accesses the value in place, without moving it out of the queue
+  template <class F>
+  [[nodiscard]]
+  bool pop_visit(F&& f)
+    requires (WorkerMode == worker_mode_t::consumer) && detail::CancelablePopVisit<traits_type, F>
+  {
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
+    typename base_type::auto_timer timer{this};
+#endif
+
+    this->mark_access();
+
+    if constexpr (traits_type::need_stop_token_for_cancel) {
+      return traits_type::cancelable_pop_visit(this->stop_token_, *this->queue_, make_visitor(f));
+
+    } else {
+      return traits_type::cancelable_pop_visit(*this->queue_, make_visitor(f));
+    }
+  }
+
+  // Pushes every value of `r` (copied), counting each of them.
+  // Uses the queue's native batch push if available; otherwise pushes one by one.
+  // Returns the number of values pushed, which is less than the size of `r` only if cancelled.
+  template <std::ranges::forward_range R>
+  [[nodiscard]]
+  std::size_t push_range_wait(R&& r)
+    requires (WorkerMode == worker_mode_t::producer) && base_type::is_counted
+  {
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
+    typename base_type::auto_timer timer{this};
+#endif
+
+    using iterator = std::ranges::iterator_t<R>;
+    std::size_t pushed = 0;
+
+    if constexpr (std::ranges::common_range<R> && detail::CancelablePushRange<traits_type, iterator>) {
+      const iterator first = std::ranges::begin(r);
+      const iterator last = [&] {
+        if constexpr (traits_type::need_stop_token_for_cancel) {
+          return traits_type::cancelable_push_range(this->stop_token_, *this->queue_, first, std::ranges::end(r));
+        } else {
+          return traits_type::cancelable_push_range(*this->queue_, first, std::ranges::end(r));
+        }
+      }();
+      pushed = static_cast<std::size_t>(std::ranges::distance(first, last));
+
+    } else {
+      for (auto&& value : r) {
+        bool ok;
+        if constexpr (traits_type::need_stop_token_for_cancel) {
+          ok = traits_type::cancelable_bounded_push(this->stop_token_, *this->queue_, std::forward<decltype(value)>(value));
+        } else {
+          ok = traits_type::cancelable_bounded_push(*this->queue_, std::forward<decltype(value)>(value));
+        }
+        if (!ok) break;
+        ++pushed;
+      }
+    }
+
+    this->count_ += static_cast<detail::queue_gate_store_counter_type>(pushed);
+    return pushed;
+  }
+
+  // Waits for at least one value, then pops as many as available up to `out.size()`, counting each of them.
+  // Queues without a native batch pop yield one value per call.
+  // Returns the number of values popped; 0 if cancelled.
+  [[nodiscard]]
+  std::size_t pop_bulk_wait(std::span<value_type> out)
+    requires (WorkerMode == worker_mode_t::consumer) && base_type::is_counted
+  {
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
+    typename base_type::auto_timer timer{this};
+#endif
+
+    if (out.empty()) return 0;
+    std::size_t popped = 0;
+
+    if constexpr (detail::CancelablePopBulk<traits_type>) {
+      if constexpr (traits_type::need_stop_token_for_cancel) {
+        popped = traits_type::cancelable_pop_bulk(this->stop_token_, *this->queue_, out.data(), out.size());
+      } else {
+        popped = traits_type::cancelable_pop_bulk(*this->queue_, out.data(), out.size());
+      }
+
+    } else {
+      bool ok;
+      if constexpr (traits_type::need_stop_token_for_cancel) {
+        ok = traits_type::cancelable_pop(this->stop_token_, *this->queue_, out.front());
+      } else {
+        ok = traits_type::cancelable_pop(*this->queue_, out.front());
+      }
+      popped = ok ? 1 : 0;
+    }
+
+    this->count_ += static_cast<detail::queue_gate_store_counter_type>(popped);
+    return popped;
+  }
+
 private:
+  template <class F>
+  [[nodiscard]]
+  auto make_visitor(F& f) noexcept
+  {
+    return [this, &f](value_type& value) noexcept(std::is_nothrow_invocable_v<F&, value_type&>) {
+#if YK_EXEC_DEBUG || YK_EXEC_WORKER_STATS
+      // the visitor's own work is not queue overhead
+      auto const start_time = std::chrono::steady_clock::now();
+      std::invoke(f, value);
+      this->add_time(start_time - std::chrono::steady_clock::now());
+#else
+      (void)this;
+      std::invoke(f, value);
+#endif
+    };
+  }
+
   void mark_access()
   {
     if constexpr (base_type::is_counted) {
@@ -4,6 +4,10 @@
 #include "yk/exec/debug.hpp"// for ODR violation safety
 
 #include <version>
+#include <concepts>
+#include <utility>
+
+#include <cstddef>
 
 #if __cpp_lib_jthread >= 201911L
 #include <stop_token>
@@ -39,8 +43,80 @@ struct queue_traits
   // [if need_stop_token_for_cancel is false]
   // You need to provide this
   [[nodiscard]] static bool cancelable_pop(queue_type& queue, value_type& value) = delete;
+
+  // [optional] in-place access; enables queue_gate::push_visit() and queue_gate::pop_visit()
+  // (takes a leading std::stop_token const& if need_stop_token_for_cancel is true)
+  //
+  // template <class F> [[nodiscard]] static bool cancelable_push_visit(queue_type& queue, F&& f); // f(value_type&) fills a new value
+  // template <class F> [[nodiscard]] static bool cancelable_pop_visit(queue_type& queue, F&& f);  // f(value_type&) reads the front value
+
+  // [optional] batch transfer; enables the native path of queue_gate::push_range_wait() and queue_gate::pop_bulk_wait()
+  // (takes a leading std::stop_token const& if need_stop_token_for_cancel is true)
+  //
+  // template <class Iterator> [[nodiscard]] static Iterator cancelable_push_range(queue_type& queue, Iterator first, Iterator last); // returns past the last pushed
+  // [[nodiscard]] static std::size_t cancelable_pop_bulk(queue_type& queue, value_type* out, std::size_t max_count);                 // returns 0 on cancel
+
+  // [optional] the queue may be accessed by one producer and one consumer only
+  // static constexpr bool is_single_producer_single_consumer = true;
 };
 
+namespace detail {
+
+template <class TraitsT, class F>
+concept CancelablePushVisit =
+#if __cpp_lib_jthread >= 201911L
+  (TraitsT::need_stop_token_for_cancel && requires(std::stop_token const& stop_token, typename TraitsT::queue_type& queue, F&& f) {
+    { TraitsT::cancelable_push_visit(stop_token, queue, std::forward<F>(f)) } -> std::same_as<bool>;
+  }) ||
+#endif
+  (!TraitsT::need_stop_token_for_cancel && requires(typename TraitsT::queue_type& queue, F&& f) {
+    { TraitsT::cancelable_push_visit(queue, std::forward<F>(f)) } -> std::same_as<bool>;
+  });
+
+template <class TraitsT, class F>
+concept CancelablePopVisit =
+#if __cpp_lib_jthread >= 201911L
+  (TraitsT::need_stop_token_for_cancel && requires(std::stop_token const& stop_token, typename TraitsT::queue_type& queue, F&& f) {
+    { TraitsT::cancelable_pop_visit(stop_token, queue, std::forward<F>(f)) } -> std::same_as<bool>;
+  }) ||
+#endif
+  (!TraitsT::need_stop_token_for_cancel && requires(typename TraitsT::queue_type& queue, F&& f) {
+    { TraitsT::cancelable_pop_visit(queue, std::forward<F>(f)) } -> std::same_as<bool>;
+  });
+
+template <class TraitsT, class Iterator>
+concept CancelablePushRange =
+#if __cpp_lib_jthread >= 201911L
+  (TraitsT::need_stop_token_for_cancel && requires(std::stop_token const& stop_token, typename TraitsT::queue_type& queue, Iterator it) {
+    { TraitsT::cancelable_push_range(stop_token, queue, it, it) } -> std::same_as<Iterator>;
+  }) ||
+#endif
+  (!TraitsT::need_stop_token_for_cancel && requires(typename TraitsT::queue_type& queue, Iterator it) {
+    { TraitsT::cancelable_push_range(queue, it, it) } -> std::same_as<Iterator>;
+  });
+
+template <class TraitsT>
+concept CancelablePopBulk =
+#if __cpp_lib_jthread >= 201911L
+  (TraitsT::need_stop_token_for_cancel && requires(std::stop_token const& stop_token, typename TraitsT::queue_type& queue, typename TraitsT::value_type* out, std::size_t n) {
+    { TraitsT::cancelable_pop_bulk(stop_token, queue, out, n) } -> std::same_as<std::size_t>;
+  }) ||
+#endif
+  (!TraitsT::need_stop_token_for_cancel && requires(typename TraitsT::queue_type& queue, typename TraitsT::value_type* out, std::size_t n) {
+    { TraitsT::cancelable_pop_bulk(queue, out, n) } -> std::same_as<std::size_t>;
+  });
+
+template <class TraitsT>
+inline constexpr bool is_single_producer_single_consumer_v = [] {
+  if constexpr (requires { TraitsT::is_single_producer_single_consumer; }) {
+    return TraitsT::is_single_producer_single_consumer;
+  } else {
+    return false;
+  }
+}();
+
+} // detail
+
 } // yk::exec
 
 #endif
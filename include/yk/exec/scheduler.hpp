@@ -6,7 +6,10 @@
 #include "yk/exec/scheduler_stats.hpp"
 #include "yk/exec/scheduler_delta_stats.hpp"
 #include "yk/exec/scheduler_stats_tracker.hpp"
+#include "yk/exec/scheduler_worker_stats.hpp"
+#include "yk/exec/scheduler_scaling_policy.hpp"
 #include "yk/exec/worker_pool.hpp"
+#include "yk/exec/worker_budget.hpp"
 #include "yk/exec/queue_gate.hpp"
 #include "yk/exec/queue_traits.hpp"
 
@@ -19,12 +22,19 @@
 
 #include <tuple>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <stop_token>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include <ranges>
 #include <concepts>
@@ -58,6 +68,11 @@ protected:
   {
     queue.close();
   }
+
+  void open_queue(queue_type& queue)
+  {
+    queue.open();
+  }
 };
 
 template <class TraitsT>
@@ -85,6 +100,12 @@ protected:
     queue_stop_source_.request_stop();
   }
 
+  // requires that no gate made before is still in use
+  void open_queue(queue_type& /*queue*/)
+  {
+    queue_stop_source_ = {};
+  }
+
 private:
   std::stop_source queue_stop_source_;
 };
@@ -113,6 +134,23 @@ public:
   using consumer_gate_type = typename base_type::consumer_gate_type;
 
   using producer_input_iterator = typename traits_type::producer_input_iterator;
+  using producer_input_value_type = typename traits_type::producer_input_value_type;
+
+#if __cpp_lib_move_only_function >= 202110L
+  using start_callback_type = std::move_only_function<void ()>;
+#else
+  using start_callback_type = std::function<void ()>;
+#endif
+
+private:
+  // single-pass iterators may not be default constructible, and begin() must be called at most once
+  using producer_input_cursor = std::conditional_t<
+    traits_type::is_streaming_input,
+    std::optional<producer_input_iterator>,
+    producer_input_iterator
+  >;
+
+public:
 
   static_assert(Producer<ProducerF, ProducerInputRangeT, producer_gate_type>);
   static_assert(Consumer<ConsumerF, consumer_gate_type>);
@@ -150,7 +188,7 @@ public:
     , consumer_func_(std::forward<ConsumerF_>(consumer_func))
     , queue_(std::forward<QueueArgs>(queue_args)...)
     , producer_inputs_(std::forward<R>(producer_inputs))
-    , last_producer_input_it_(std::ranges::begin(producer_inputs_))
+    , last_producer_input_it_(begin_producer_inputs())
     , stats_(producer_inputs_)
   {
   }
@@ -171,6 +209,7 @@ public:
   template <ProducerInputRange ProducerInputRangeT_>
   void set_producer_inputs(ProducerInputRangeT_&& r)
   {
+    this->join_finished_workers();
     std::scoped_lock lock{stats_mtx_, producer_input_mtx_};
 
     if (stats_.is_running) {
@@ -181,8 +220,9 @@ public:
     }
 
     producer_inputs_ = std::forward<ProducerInputRangeT_>(r);
-    last_producer_input_it_ = std::ranges::begin(producer_inputs_);
-    stats_ = {producer_inputs_};
+    last_producer_input_it_ = begin_producer_inputs();
+    producer_input_exhausted_ = false;
+    stats_ = scheduler_stats{producer_inputs_};
   }
 
   // thread-safe
@@ -195,8 +235,11 @@ public:
   }
 
   // not thread-safe
+  // single-pass inputs cannot be rewound; use set_producer_inputs() instead
   void reset_same_inputs_for_next_execution()
+    requires (!traits_type::is_streaming_input)
   {
+    this->join_finished_workers();
     std::scoped_lock lock{stats_mtx_, producer_input_mtx_};
 
     if (stats_.is_running) {
@@ -204,7 +247,7 @@ public:
     }
 
     last_producer_input_it_ = std::ranges::begin(producer_inputs_);
-    stats_ = {producer_inputs_};
+    stats_ = scheduler_stats{producer_inputs_};
   }
 
   // thread-safe
@@ -226,6 +269,64 @@ public:
     producer_chunk_size_ = chunk_size;
   }
 
+  // thread-safe
+  [[nodiscard]]
+  scheduler_stats get_stats() const
+  {
+    std::unique_lock lock{stats_mtx_};
+    return stats_;
+  }
+
+  // thread-safe
+  // indexed by thread_index_t; empty before the first start(), and all zero unless YK_EXEC_WORKER_STATS
+  [[nodiscard]]
+  std::vector<scheduler_worker_stats> get_worker_stats() const
+  {
+    std::unique_lock lock{stats_mtx_};
+    return collect_worker_stats();
+  }
+
+  // not thread-safe
+  // scaling decisions are made on each stats tracker tick; start() throws if no tracker is set
+  // requires YK_EXEC_WORKER_STATS, since the decisions are based on the per-worker stats
+  // parked workers give their worker budget slots back; without a policy, every worker holds its slot
+  // until the tasks are done, even while blocked on the queue or the input
+  void set_scaling_policy(std::optional<scheduler_scaling_policy> policy)
+  {
+#if !YK_EXEC_WORKER_STATS
+    if (policy) {
+      throwt<std::logic_error>("scaling policies require YK_EXEC_WORKER_STATS=1");
+    }
+#endif
+    if (policy) policy->validate();
+    scaling_policy_ = std::move(policy);
+  }
+
+  // not thread-safe
+  [[nodiscard]]
+  const std::optional<scheduler_scaling_policy>& get_scaling_policy() const noexcept
+  {
+    return scaling_policy_;
+  }
+
+  // not thread-safe
+  // invoked by start() before any worker is launched; the workers of the previous run have been joined
+  // by then (see wait_for_all_tasks()), so no item of this scheduler is alive, e.g. reset the arenas
+  // backing the items of the previous run
+  void set_start_callback(start_callback_type callback)
+  {
+    start_callback_ = std::move(callback);
+  }
+
+  // thread-safe
+  // number of workers allowed to run, including the fixed producer and the fixed consumer;
+  // the rest of the launched workers are parked
+  [[nodiscard]]
+  int get_active_worker_count() const noexcept
+  {
+    return active_worker_limit_.load(std::memory_order_relaxed);
+  }
+
   // not thread-safe
   [[nodiscard]]
   const scheduler_stats_tracker* get_stats_tracker() const noexcept
@@ -271,13 +372,15 @@ public:
           );
 
           const auto stats = stats_;
+          const auto worker_stats = collect_worker_stats();
           lock.unlock();
 
           if (stop_token.stop_requested() || !cv_ok) {
             return;
           }
 
-          stats_tracker_->tick(stats);
+          stats_tracker_->tick(stats, worker_stats);
+          rescale_workers();
         }
 
       } catch (...) {
@@ -306,6 +409,44 @@ public:
       if (stats_.is_producer_input_processed_all()) {
         throwt<std::invalid_argument>("Cannot start the scheduler after a successful iteration. If this is your intended action, call: reset_same_inputs_for_next_execution()");
       }
+      if (scaling_policy_ && !stats_tracker_) {
+        throwt<std::invalid_argument>("Cannot start the scheduler with a scaling policy but without a stats tracker");
+      }
+      if (!worker_ids_.empty()) {
+        throwt<std::invalid_argument>("Cannot start the scheduler while the workers of the previous run are alive; call wait_for_all_tasks() or abort() first");
+      }
+
+      // see launch_rest() below; parked workers stay launched
+      worker_budget_ = worker_pool_->get_worker_budget();
+      first_worker_id_ = static_cast<thread_index_t>(worker_pool_->launched_worker_count());
+      const int worker_count = std::max(worker_pool_->get_worker_limit() - worker_pool_->launched_worker_count(), 2);
+
+      if constexpr (detail::is_single_producer_single_consumer_v<queue_traits_type>) {
+        if (worker_count != 2) {
+          throwt<std::invalid_argument>("Cannot start the scheduler on a single-producer single-consumer queue with {} workers; it requires exactly 2", worker_count);
+        }
+      }
+
+      if (scaling_policy_) {
+        scaler_.emplace(*scaling_policy_, worker_count);
+        active_worker_limit_.store(scaler_->min_workers(), std::memory_order_relaxed);
+      } else {
+        scaler_.reset();
+        active_worker_limit_.store(worker_count, std::memory_order_relaxed);
+      }
+
+      // fixed consumer + fixed producer + the rest; see worker_pool::launch_rest
+      worker_stats_count_ = static_cast<std::size_t>(
+        std::max(worker_pool_->get_worker_limit(), worker_pool_->launched_worker_count() + 2)
+      );
+      worker_stats_counters_ = std::make_unique<detail::scheduler_worker_stats_counter[]>(worker_stats_count_);
+
+      worker_ids_.reserve(worker_stats_count_); // see launch_workers()
+      all_task_done_.store(false, std::memory_order_relaxed);
+    }
+
+    if (start_callback_) {
+      start_callback_();
     }
 
     if (stats_tracker_) {
@@ -319,24 +460,27 @@ public:
 
     worker_pool_->set_rethrow_exceptions_on_exit(true);
 
-    worker_pool_->launch([this](const thread_index_t worker_id, std::stop_token stop_token) {
+    // the fixed consumer launches the others once the worker budget lets the fixed pair run
+    std::unique_lock lock{stats_mtx_};
+    worker_ids_.push_back(worker_pool_->launch([this](const thread_index_t worker_id, std::stop_token stop_token) {
       this->fixed_consumer(worker_id, std::move(stop_token));
-    });
-
-    worker_pool_->launch([this](const thread_index_t worker_id, std::stop_token stop_token) {
-      this->fixed_producer(worker_id, std::move(stop_token));
-    });
-
-    worker_pool_->launch_rest([this](const thread_index_t worker_id, std::stop_token stop_token) {
-      this->dynamic_worker(worker_id, std::move(stop_token), worker_mode_t::producer);
-    });
+    }));
   }
 
   // thread-safe
   // must be called from the main thread
+  // once the tasks are done, joins the workers so that the next start() sees no item of this run alive
   void wait_for_all_tasks()
+  {
+    this->wait_for_all_tasks_impl<true>();
+  }
+
+private:
+  template <bool JoinWorkers>
+  void wait_for_all_tasks_impl()
   {
     scheduler_stats prev_stats;
+    std::vector<scheduler_worker_stats> prev_worker_stats;
 
     {
       std::unique_lock lock{stats_mtx_};
@@ -345,6 +489,7 @@ public:
       });
 
       prev_stats = stats_;
+      prev_worker_stats = collect_worker_stats();
     }
 
     YK_EXEC_DEBUG_PRINT(std::println("wait_for_all_tasks: notified"));
@@ -363,7 +508,7 @@ public:
       }
 
       // always print tick at the end
-      stats_tracker_->tick(prev_stats);
+      stats_tracker_->tick(prev_stats, prev_worker_stats);
     }
 
     if (worker_pool_->stop_requested()) {
@@ -377,6 +522,10 @@ public:
     } else {
       YK_EXEC_DEBUG_PRINT(std::println("wait_for_all_tasks: task completed"));
 
+      if constexpr (JoinWorkers) {
+        this->join_finished_workers();
+      }
+
       // TODO: report this
       //auto const remaining_tasks = queue_.size();
       //if (remaining_tasks != 0) {
@@ -385,11 +534,77 @@ public:
     }
   }
 
+public:
+  // thread-safe, but must be called from the master thread
+  //
+  // Stops handing out producer inputs and lets the workers finish what is already
+  // in flight or queued until `deadline`; then abort()s.
+  // Returns true if everything finished in time. Either way, the number of
+  // dropped items is recorded in scheduler_stats::*_dropped.
+  //
+  // For single-pass inputs, a pull in flight is not waited for before the deadline;
+  // the values it has pulled are dropped once it returns. abort() still joins the
+  // pulling worker, so an input that may block indefinitely should also stop on
+  // the worker pool's stop_token(). On success, the workers are joined by the next
+  // set_producer_inputs(), reset_same_inputs_for_next_execution() or abort() instead.
+  template <class Clock, class Duration>
+  bool drain(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    {
+      std::scoped_lock lock{producer_input_mtx_, stats_mtx_};
+
+      if (!stats_.is_producer_input_consumed_all()) {
+        stats_.producer_input_dropped = stats_.producer_input_remaining();
+
+        if constexpr (traits_type::is_streaming_input) {
+          producer_input_exhausted_.store(true, std::memory_order_relaxed);
+        } else {
+          last_producer_input_it_ = std::ranges::end(producer_inputs_);
+        }
+        stats_.set_producer_input_consumed_all();
+
+        // otherwise, the last in-flight producer will set this
+        if (stats_.producer_input_processed >= stats_.producer_input_consumed) {
+          stats_.set_producer_input_processed_all();
+          if (stats_.is_all_task_done()) {
+            notify_all_task_done();
+          }
+        }
+      }
+    }
+    task_done_cv_.notify_all();
+
+    bool done;
+    {
+      std::unique_lock lock{stats_mtx_};
+      done = task_done_cv_.wait_until(lock, worker_pool_->stop_token(), deadline, [this] {
+        return stats_.is_all_task_done();
+      });
+    }
+
+    if (done) {
+      this->wait_for_all_tasks_impl<false>(); // a pull in flight may still block the producer
+      return true;
+    }
+
+    YK_EXEC_DEBUG_PRINT(std::println("drain: deadline exceeded"));
+    this->abort();
+
+    // all workers are joined at this point
+    std::unique_lock lock{stats_mtx_};
+    if (stats_.producer_input_dropped != scheduler_stats::UNPREDICTABLE) {
+      stats_.producer_input_dropped += stats_.producer_input_consumed - stats_.producer_input_processed; // in-flight chunks
+    }
+    stats_.consumer_input_dropped = stats_.producer_output - stats_.consumer_input_processed;
+    return false;
+  }
+
   // thread-safe, but must be called from the master thread
   void abort()
   {
     this->close_queue(queue_);
     worker_pool_->halt_and_clear();
+    worker_ids_.clear();
 
     stats_tracker_thread_.request_stop();
     if (stats_tracker_thread_.joinable()) {
@@ -402,36 +617,285 @@ public:
   [[nodiscard]] queue_type& queue() noexcept { return queue_; }
 
 private:
+  // requires stats_mtx_
+  // Workers do not exit by themselves while blocked on the empty queue, so close it; they then
+  // return their worker budget slots. join_finished_workers() reopens it for the next run.
+  void notify_all_task_done()
+  {
+    all_task_done_.store(true, std::memory_order_relaxed);
+    this->close_queue(queue_);
+    task_done_cv_.notify_all();
+    if (worker_budget_) worker_budget_->notify_all();
+  }
+
+  // called by the fixed consumer, holding both slots of the fixed pair;
+  // launches the fixed producer, which takes over the second slot, and the rest.
+  // Returns false if there is nothing left to do.
+  bool launch_workers()
+  {
+    // worker_ids_ has been reserved, so push_back() does not throw once a worker is launched
+    std::unique_lock lock{stats_mtx_};
+    if (stats_.is_all_task_done()) {
+      if (worker_budget_) worker_budget_->release();
+      return false;
+    }
+
+    try {
+      worker_ids_.push_back(worker_pool_->launch([this](const thread_index_t worker_id, std::stop_token stop_token) {
+        this->fixed_producer(worker_id, std::move(stop_token));
+      }));
+    } catch (...) {
+      if (worker_budget_) worker_budget_->release();
+      throw;
+    }
+
+    worker_pool_->launch_rest([this](const thread_index_t worker_id, std::stop_token stop_token) {
+      this->dynamic_worker(worker_id, std::move(stop_token), worker_mode_t::producer);
+    }, worker_ids_);
+    return true;
+  }
+
+  // not thread-safe
+  // joins the workers of a finished run, and reopens the queue for the next one
+  void join_finished_workers()
+  {
+    if (worker_pool_->stop_requested()) return; // abort() joins them
+
+    {
+      // no worker is launched once the tasks are done; see launch_workers()
+      std::unique_lock lock{stats_mtx_};
+      if (worker_ids_.empty() || !stats_.is_all_task_done()) return;
+    }
+
+    this->close_queue(queue_); // already closed by notify_all_task_done(), unless drain() finished the job
+    worker_pool_->join(worker_ids_);
+    worker_ids_.clear();
+    this->open_queue(queue_);
+  }
+
+  // requires stats_mtx_
+  [[nodiscard]]
+  std::vector<scheduler_worker_stats> collect_worker_stats() const
+  {
+    std::vector<scheduler_worker_stats> res;
+    res.reserve(worker_stats_count_);
+    for (std::size_t i = 0; i < worker_stats_count_; ++i) {
+      res.emplace_back(worker_stats_counters_[i].load());
+    }
+    return res;
+  }
+
+  [[nodiscard]]
+  detail::scheduler_worker_stats_counter* worker_stats_counter(const thread_index_t worker_id) noexcept
+  {
+    // set before the workers are launched, so no lock is needed here
+    return worker_id < worker_stats_count_ ? &worker_stats_counters_[worker_id] : nullptr;
+  }
+
+  [[nodiscard]]
+  bool is_worker_active(const thread_index_t worker_id) const noexcept
+  {
+    return static_cast<long long>(worker_id - first_worker_id_) < active_worker_limit_.load(std::memory_order_relaxed);
+  }
+
+  // returns false if there is nothing left to do
+  [[nodiscard]]
+  bool park_worker(const thread_index_t worker_id, const std::stop_token& stop_token)
+  {
+    detail::scheduler_worker_stats_recorder recorder{worker_stats_counter(worker_id)};
+
+    std::unique_lock lock{stats_mtx_};
+    task_done_cv_.wait(lock, stop_token, [&] {
+      return is_worker_active(worker_id) || stats_.is_all_task_done();
+    });
+    recorder.mark_parked();
+
+    return !stats_.is_all_task_done();
+  }
+
+  // returns false if there is nothing left to do
+  [[nodiscard]]
+  bool wait_for_budget(const thread_index_t worker_id, const std::stop_token& stop_token, worker_budget_lease& lease)
+  {
+    detail::scheduler_worker_stats_recorder recorder{worker_stats_counter(worker_id)};
+
+    // woken by notify_all_task_done() and rescale_workers()
+    const bool acquired = lease.acquire(stop_token, [&] {
+      return all_task_done_.load(std::memory_order_relaxed) || !is_worker_active(worker_id);
+    });
+    recorder.mark_parked();
+    if (acquired) return true;
+
+    std::unique_lock lock{stats_mtx_};
+    return !stats_.is_all_task_done();
+  }
+
+  // called from the stats tracker thread after each tick
+  void rescale_workers()
+  {
+    scheduler_worker_stats sum;
+    for (const auto& ws : stats_tracker_->delta_worker_stats()) sum += ws;
+
+    // no chunk has finished since the last tick; nothing to judge from
+    if (sum.total_time() == scheduler_worker_stats::duration_type::zero()) return;
+
+    const double utilization = sum.utilization();
+    const double queue_ratio = stats_tracker_->queue_ratio();
+
+    {
+      std::unique_lock lock{stats_mtx_};
+      if (!scaler_) return;
+
+      const int active = active_worker_limit_.load(std::memory_order_relaxed);
+      const int next = scaler_->update(active, utilization, queue_ratio, !stats_.is_producer_input_consumed_all());
+      if (next == active) return;
+
+      YK_EXEC_DEBUG_PRINT(std::println("scheduler: active workers {} -> {}", active, next));
+      active_worker_limit_.store(next, std::memory_order_relaxed);
+    }
+
+    task_done_cv_.notify_all(); // wake parked workers
+    if (worker_budget_) worker_budget_->notify_all(); // let the deactivated ones stop waiting for the budget
+  }
+
+  [[nodiscard]]
+  producer_input_cursor begin_producer_inputs()
+  {
+    if constexpr (traits_type::is_streaming_input) {
+      return std::nullopt; // begin() is deferred to the first pull
+    } else {
+      return std::ranges::begin(producer_inputs_);
+    }
+  }
+
+  [[nodiscard]]
+  producer_input_cursor end_producer_inputs()
+  {
+    if constexpr (traits_type::is_streaming_input) {
+      return std::nullopt;
+    } else {
+      return std::ranges::end(producer_inputs_);
+    }
+  }
+
   template <bool NeedInfo>
   [[nodiscard]]
   std::conditional_t<NeedInfo, std::pair<bool, double>, bool>
   do_worker_producer(const thread_index_t worker_id)
   {
-    producer_input_iterator it_first, it_last;
+    detail::scheduler_worker_stats_recorder recorder{worker_stats_counter(worker_id)};
+
+    if constexpr (traits_type::is_streaming_input) {
+      // reused across chunks to keep the capacity
+      thread_local std::vector<producer_input_value_type> chunk;
+      chunk.clear();
+
+      {
+        // pulling may block (e.g. on I/O), so it is serialized by its own mutex
+        // that only other producers wait for; drain() closes the input through the atomic flag
+        std::unique_lock pull_lock{producer_pull_mtx_};
+
+        long long chunk_size;
+        {
+          std::unique_lock input_lock{producer_input_mtx_};
+          chunk_size = producer_chunk_size_;
+        }
+        recorder.mark_blocked();
 
-    unsigned long long count;
-    {
-      std::scoped_lock lock{producer_input_mtx_, stats_mtx_};
+        if (producer_input_exhausted_.load(std::memory_order_relaxed)) {
+          return {}; // all producer done; need to switch to consumer
+        }
+
+        if (!last_producer_input_it_) {
+          last_producer_input_it_.emplace(std::ranges::begin(producer_inputs_));
+        }
+        auto& it = *last_producer_input_it_;
+        auto const producer_input_end = std::ranges::end(producer_inputs_);
+
+        for (; it != producer_input_end && std::cmp_less(chunk.size(), chunk_size); ++it) {
+          if (producer_input_exhausted_.load(std::memory_order_relaxed)) break; // closed by drain()
+          chunk.emplace_back(std::ranges::iter_move(it));
+        }
+        const bool reached_end = it == producer_input_end;
+        if (reached_end) {
+          producer_input_exhausted_.store(true, std::memory_order_relaxed);
+        }
+
+        std::unique_lock lock{stats_mtx_};
 
-      auto const producer_input_end = std::ranges::end(producer_inputs_);
+        // drain() has closed the input during the pull; the values pulled so far are dropped
+        if (stats_.is_producer_input_consumed_all()) {
+          return {}; // need to switch to consumer
+        }
+
+        stats_.producer_input_consumed += static_cast<scheduler_stats::count_type>(chunk.size());
+
+        if (reached_end) {
+          stats_.set_producer_input_consumed_all();
+
+          // nothing was pulled; the last in-flight producer (if any) finishes the job
+          if (chunk.empty() && stats_.producer_input_processed >= stats_.producer_input_consumed) {
+            stats_.set_producer_input_processed_all();
+            if (stats_.is_all_task_done()) {
+              notify_all_task_done();
+            }
+          }
+        }
 
-      it_first = last_producer_input_it_;
-      if (it_first == producer_input_end) {
-        return {}; // all producer done; need to switch to consumer
+        if (chunk.empty()) {
+          return {}; // need to switch to consumer
+        }
       }
 
-      it_last = it_first;
-      count = producer_chunk_size_ - static_cast<unsigned long long>(
-        std::ranges::advance(it_last, producer_chunk_size_, producer_input_end)
+      auto res = run_producer_chunk<NeedInfo>(
+        worker_id, recorder,
+        std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()),
+        chunk.size()
       );
-      last_producer_input_it_ = it_last;
+      chunk.clear();
+      return res;
+
+    } else {
+      producer_input_iterator it_first, it_last;
 
-      stats_.producer_input_consumed += count;
+      unsigned long long count;
+      {
+        std::scoped_lock lock{producer_input_mtx_, stats_mtx_};
+        recorder.mark_blocked();
 
-      if (it_last == producer_input_end) {
-        stats_.set_producer_input_consumed_all();
+        auto const producer_input_end = std::ranges::end(producer_inputs_);
+
+        it_first = last_producer_input_it_;
+        if (it_first == producer_input_end) {
+          return {}; // all producer done; need to switch to consumer
+        }
+
+        it_last = it_first;
+        count = producer_chunk_size_ - static_cast<unsigned long long>(
+          std::ranges::advance(it_last, producer_chunk_size_, producer_input_end)
+        );
+        last_producer_input_it_ = it_last;
+
+        stats_.producer_input_consumed += count;
+
+        if (it_last == producer_input_end) {
+          stats_.set_producer_input_consumed_all();
+        }
       }
+
+      return run_producer_chunk<NeedInfo>(worker_id, recorder, it_first, it_last, count);
     }
+  }
+
+  template <bool NeedInfo, class Iterator>
+  [[nodiscard]]
+  std::conditional_t<NeedInfo, std::pair<bool, double>, bool>
+  run_producer_chunk(
+    const thread_index_t worker_id, detail::scheduler_worker_stats_recorder& recorder,
+    Iterator it_first, Iterator it_last, unsigned long long count
+  )
+  {
+    recorder.mark_switch();
 
     // ===== begin producer =====
     auto gate = this->make_producer_gate(&queue_);
@@ -454,11 +918,16 @@ private:
 
     // ===== end producer =====
 
+#if YK_EXEC_WORKER_STATS
+    recorder.mark_busy(gate.elapsed_time());
+#endif
+
     thread_local scheduler_stats prev_stats{};
     double p_c_ratio;
 
     {
       std::unique_lock lock{stats_mtx_};
+      recorder.mark_blocked();
 
 #if YK_EXEC_DEBUG
       stats_.producer_time += process_time;
@@ -481,7 +950,7 @@ private:
 
       // (reversed pattern; consumer outpaced our process)
       if (stats_.is_all_task_done()) {
-        task_done_cv_.notify_all();
+        notify_all_task_done();
         return {}; // need to switch to consumer
       }
 
@@ -514,6 +983,8 @@ private:
 
     auto gate = this->make_consumer_gate(&queue_);
 
+    detail::scheduler_worker_stats_recorder recorder{worker_stats_counter(worker_id)};
+
 #if YK_EXEC_DEBUG
     auto const start_time = std::chrono::steady_clock::now();
 #endif
@@ -526,11 +997,20 @@ private:
 
     // ===== end consumer =====
 
+#if YK_EXEC_WORKER_STATS
+    recorder.mark_busy(gate.elapsed_time());
+#endif
+
     thread_local scheduler_stats prev_stats{};
     double p_c_ratio;
 
     {
       std::unique_lock lock{stats_mtx_};
+      recorder.mark_blocked();
+
+      if (stats_.is_all_task_done()) {
+        return {}; // woken by the queue closing at the end of the run; nothing was popped
+      }
 
 #if YK_EXEC_DEBUG
       stats_.consumer_time += process_time;
@@ -544,7 +1024,7 @@ private:
       }
 
       if (stats_.is_all_task_done()) {
-        task_done_cv_.notify_all();
+        notify_all_task_done();
         return {}; // need to switch to consumer
       }
 
@@ -567,6 +1047,10 @@ private:
 
   void fixed_producer(const thread_index_t worker_id, std::stop_token stop_token)
   {
+    // the second slot of the fixed pair; held until exit, even while blocked in the gate
+    worker_budget_lease lease{worker_budget_.get()};
+    lease.adopt();
+
     while (!stop_token.stop_requested()) {
       if (!do_worker_producer<false>(worker_id)) {
         break;
@@ -576,6 +1060,10 @@ private:
       return;
     }
 
+    if constexpr (detail::is_single_producer_single_consumer_v<queue_traits_type>) {
+      return; // the fixed consumer is the only thread allowed to pop
+    }
+
     while (!stop_token.stop_requested()) {
       if (!do_worker_consumer<false>(worker_id)) {
         break;
@@ -585,6 +1073,21 @@ private:
 
   void fixed_consumer(const thread_index_t worker_id, std::stop_token stop_token)
   {
+    // held until exit, even while blocked in the gate
+    worker_budget_lease lease{worker_budget_.get()};
+
+    if (worker_budget_) {
+      // the fixed pair takes its slots at once; taken one by one, every scheduler sharing
+      // the budget could end up with only its producer running, blocked on a full queue
+      const bool acquired = worker_budget_->acquire(stop_token, 2, [this] {
+        return all_task_done_.load(std::memory_order_relaxed); // e.g. drained meanwhile
+      });
+      if (!acquired) return;
+      lease.adopt();
+    }
+
+    if (!launch_workers()) return;
+
     while (!stop_token.stop_requested()) {
       if (!do_worker_consumer<false>(worker_id)) {
         break;
@@ -594,7 +1097,20 @@ private:
 
   void dynamic_worker(const thread_index_t worker_id, std::stop_token stop_token, worker_mode_t worker_mode)
   {
+    // held while running; returned when parked so that other pools sharing the budget can use it
+    worker_budget_lease lease{worker_budget_.get()};
+
     while (!stop_token.stop_requested()) {
+      if (!is_worker_active(worker_id)) {
+        lease.release();
+        if (!park_worker(worker_id, stop_token)) return;
+        continue;
+      }
+      if (!lease.try_acquire()) {
+        if (!wait_for_budget(worker_id, stop_token, lease)) return;
+        continue;
+      }
+
       if (worker_mode == worker_mode_t::producer) {
         const auto [ok, p_c_ratio] = do_worker_producer<true>(worker_id);
         if (!ok) {
@@ -637,8 +1153,10 @@ YK_FORCEALIGN_BEGIN
 
   alignas(yk::hardware_destructive_interference_size) mutable std::mutex producer_input_mtx_;
   ProducerInputRangeT producer_inputs_{};
-  producer_input_iterator last_producer_input_it_ = std::ranges::end(producer_inputs_);
+  producer_input_cursor last_producer_input_it_ = end_producer_inputs(); // guarded by producer_pull_mtx_ for single-pass inputs
+  std::atomic<bool> producer_input_exhausted_ = false; // single-pass inputs only; also set by drain()
   long long producer_chunk_size_ = 1;
+  std::mutex producer_pull_mtx_; // single-pass inputs only; held while pulling
 
   // -----------------------------
 
@@ -646,6 +1164,24 @@ YK_FORCEALIGN_BEGIN
   alignas(yk::hardware_destructive_interference_size) std::condition_variable_any task_done_cv_;
   alignas(yk::hardware_destructive_interference_size) scheduler_stats stats_{producer_inputs_};
 
+  // guarded by stats_mtx_; each worker writes to its own counter
+  std::unique_ptr<detail::scheduler_worker_stats_counter[]> worker_stats_counters_;
+  std::size_t worker_stats_count_ = 0;
+
+  // -----------------------------
+
+  std::optional<scheduler_scaling_policy> scaling_policy_;
+  std::optional<scheduler_scaler> scaler_; // guarded by stats_mtx_
+  thread_index_t first_worker_id_ = 0;
+  std::vector<thread_index_t> worker_ids_; // guarded by stats_mtx_; launched by the current (or last finished) run
+  std::atomic<bool> all_task_done_ = false; // readable under the worker budget's lock; see notify_all_task_done()
+  std::shared_ptr<worker_budget> worker_budget_;
+  alignas(yk::hardware_destructive_interference_size) std::atomic<int> active_worker_limit_{0};
+
+  // -----------------------------
+
+  start_callback_type start_callback_;
+
   // -----------------------------
 
   std::unique_ptr<scheduler_stats_tracker> stats_tracker_;
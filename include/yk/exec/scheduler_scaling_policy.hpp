@@ -0,0 +1,123 @@
+#ifndef YK_EXEC_SCHEDULER_SCALING_POLICY_HPP
+#define YK_EXEC_SCHEDULER_SCALING_POLICY_HPP
+
+#include "yk/exec/debug.hpp" // for ODR violation safety
+
+#include "yk/throwt.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace yk::exec {
+
+// Bounds and thresholds for adjusting the number of running workers of a scheduler.
+// Decisions are made once per stats tracker tick, from the per-worker stats since the last tick.
+struct scheduler_scaling_policy
+{
+  // includes the fixed producer and the fixed consumer
+  int min_workers = 2;
+
+  // 0 means worker_pool::get_worker_limit()
+  int max_workers = 0;
+
+  // add a worker when the running workers are at least this busy...
+  double scale_up_utilization = 0.9;
+
+  // ...or when they spend at least this share of time waiting on the queue (full or empty)
+  double scale_up_queue_ratio = 0.5;
+
+  // park a worker when the running workers are less busy than this, and not queue-bound
+  double scale_down_utilization = 0.5;
+
+  // the condition must hold for this many consecutive ticks before acting
+  int patience = 3;
+
+  // number of workers added or parked at once
+  int step = 1;
+
+  void validate() const
+  {
+    if (min_workers < 2) {
+      throwt<std::invalid_argument>("min_workers must be >= 2");
+    }
+    if (max_workers != 0 && max_workers < min_workers) {
+      throwt<std::invalid_argument>("max_workers must be 0 or >= min_workers");
+    }
+    if (!(0.0 <= scale_down_utilization && scale_down_utilization < scale_up_utilization && scale_up_utilization <= 1.0)) {
+      throwt<std::invalid_argument>("scaling thresholds must satisfy 0 <= scale_down_utilization < scale_up_utilization <= 1");
+    }
+    if (!(0.0 < scale_up_queue_ratio && scale_up_queue_ratio <= 1.0)) {
+      throwt<std::invalid_argument>("scale_up_queue_ratio must be in (0, 1]");
+    }
+    if (patience < 1) {
+      throwt<std::invalid_argument>("patience must be >= 1");
+    }
+    if (step < 1) {
+      throwt<std::invalid_argument>("step must be >= 1");
+    }
+  }
+};
+
+// Stateful part of the scaling policy; not thread-safe.
+class scheduler_scaler
+{
+public:
+  // max_workers: the number of workers actually available to the scheduler
+  scheduler_scaler(const scheduler_scaling_policy& policy, int max_workers)
+    : policy_(policy)
+  {
+    policy_.validate();
+
+    const int available = std::max(max_workers, 2);
+    max_workers_ = policy_.max_workers == 0 ? available : std::min(policy_.max_workers, available);
+    min_workers_ = std::min(policy_.min_workers, max_workers_);
+  }
+
+  [[nodiscard]] int min_workers() const noexcept { return min_workers_; }
+  [[nodiscard]] int max_workers() const noexcept { return max_workers_; }
+
+  [[nodiscard]] const scheduler_scaling_policy& policy() const noexcept { return policy_; }
+
+  // returns the new number of running workers
+  // input_pending: whether producer inputs are left; waiting on the queue at the tail of a job is not a reason to scale up
+  [[nodiscard]]
+  int update(int active_workers, double utilization, double queue_ratio, bool input_pending = true) noexcept
+  {
+    const bool queue_bound = input_pending && queue_ratio >= policy_.scale_up_queue_ratio;
+
+    if (utilization >= policy_.scale_up_utilization || queue_bound) {
+      ++up_streak_;
+      down_streak_ = 0;
+    } else if (utilization < policy_.scale_down_utilization) {
+      ++down_streak_;
+      up_streak_ = 0;
+    } else {
+      up_streak_ = down_streak_ = 0;
+    }
+
+    int next = active_workers;
+    if (up_streak_ >= policy_.patience) {
+      next = active_workers + policy_.step;
+      up_streak_ = 0;
+    } else if (down_streak_ >= policy_.patience) {
+      next = active_workers - policy_.step;
+      down_streak_ = 0;
+    }
+    return std::clamp(next, min_workers_, max_workers_);
+  }
+
+  void reset() noexcept
+  {
+    up_streak_ = down_streak_ = 0;
+  }
+
+private:
+  scheduler_scaling_policy policy_;
+  int min_workers_ = 2, max_workers_ = 2;
+  int up_streak_ = 0, down_streak_ = 0;
+};
+
+} // yk::exec
+
+#endif
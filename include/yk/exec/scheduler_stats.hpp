@@ -35,6 +35,14 @@ struct scheduler_stats {
 
   count_type consumer_input_processed = 0; // type is T
 
+  // ----- set by scheduler::drain() -----
+
+  // inputs that were never handed to producers; UNPREDICTABLE if the total was unpredictable
+  count_type producer_input_dropped = 0; // type is producer_input_value_type
+
+  // outputs left in the queue (or being consumed) when the deadline passed
+  count_type consumer_input_dropped = 0; // type is T
+
   // =============================================
 
 #if YK_EXEC_DEBUG
@@ -70,7 +78,9 @@ struct scheduler_stats {
       producer_input_consumed == other.producer_input_consumed &&
       producer_input_processed == other.producer_input_processed &&
       producer_output == other.producer_output &&
-      consumer_input_processed == other.consumer_input_processed
+      consumer_input_processed == other.consumer_input_processed &&
+      producer_input_dropped == other.producer_input_dropped &&
+      consumer_input_dropped == other.consumer_input_dropped
     ;
   }
 
@@ -119,12 +129,20 @@ struct scheduler_stats {
 
     } else {
       producer_input_processed_all_ = true;
-      if (producer_input_processed != producer_input_total) {
-        throwt<std::logic_error>("attempted to set producer_input_processed_all, but total count ({}) and processed count ({}) does not match", producer_input_total, producer_input_processed);
+      if (producer_input_processed + producer_input_dropped != producer_input_total) {
+        throwt<std::logic_error>("attempted to set producer_input_processed_all, but total count ({}) and processed count ({}) + dropped count ({}) does not match", producer_input_total, producer_input_processed, producer_input_dropped);
       }
     }
   }
 
+  // inputs not yet handed to producers; UNPREDICTABLE if the total is unpredictable
+  [[nodiscard]]
+  count_type producer_input_remaining() const noexcept
+  {
+    if (producer_input_total == UNPREDICTABLE) return UNPREDICTABLE;
+    return producer_input_total - producer_input_consumed;
+  }
+
   [[nodiscard]]
   bool is_consumer_input_processed_all() const noexcept
   {
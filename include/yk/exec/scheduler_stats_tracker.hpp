@@ -4,11 +4,15 @@
 #include "yk/exec/debug.hpp"// for ODR violation safety
 #include "yk/exec/scheduler_stats.hpp"
 #include "yk/exec/scheduler_delta_stats.hpp"
+#include "yk/exec/scheduler_worker_stats.hpp"
+#include "yk/exec/thread_index.hpp"
 
 #include <version>
 #include <chrono>
 #include <functional>
 #include <concepts>
+#include <span>
+#include <vector>
 
 
 namespace yk::exec {
@@ -63,6 +67,7 @@ public:
   {
     first_tick_ = clock_type::now();
     delta_stats_ = {};
+    delta_worker_stats_.clear();
   }
 
   template <class Duration = std::chrono::duration<double>>
@@ -85,16 +90,81 @@ public:
 
   // ------------------------------------------------------
 
+  // cumulative, indexed by thread_index_t
+  [[nodiscard]] std::span<const scheduler_worker_stats> worker_stats() const noexcept { return worker_stats_; }
+
+  // since the last tick, indexed by thread_index_t
+  [[nodiscard]] std::span<const scheduler_worker_stats> delta_worker_stats() const noexcept { return delta_worker_stats_; }
+
+  // busy ratio of a single worker since the last tick
+  [[nodiscard]] double worker_utilization(thread_index_t worker_id) const noexcept
+  {
+    if (worker_id >= delta_worker_stats_.size()) return 0.0;
+    return delta_worker_stats_[worker_id].utilization();
+  }
+
+  // busy ratio of all running workers since the last tick; parked time is not counted
+  [[nodiscard]] double utilization() const noexcept
+  {
+    scheduler_worker_stats sum;
+    for (const auto& ws : delta_worker_stats_) sum += ws;
+    return sum.utilization();
+  }
+
+  // share of the running workers' time spent inside queue operations since the last tick;
+  // high values mean the queue stayed full (producers wait) or empty (consumers wait)
+  [[nodiscard]] double queue_ratio() const noexcept
+  {
+    scheduler_worker_stats sum;
+    for (const auto& ws : delta_worker_stats_) sum += ws;
+
+    const auto total = sum.total_time();
+    if (total == scheduler_worker_stats::duration_type::zero()) return 0.0;
+    return yk::duration_cast<double, std::nano>(sum.queue_time) / total;
+  }
+
+  // number of workers that were effectively busy since the last tick;
+  // this is the figure to compare against worker_pool::get_worker_limit()
+  [[nodiscard]] double busy_workers() const noexcept
+  {
+    const auto delta = delta_time<std::chrono::duration<double, std::nano>>();
+    if (delta.count() <= 0) return 0.0;
+
+    scheduler_worker_stats sum;
+    for (const auto& ws : delta_worker_stats_) sum += ws;
+    return yk::duration_cast<double, std::nano>(sum.busy_time) / delta;
+  }
+
+  // ------------------------------------------------------
+
   [[nodiscard]] bool interval_elapsed() const noexcept
   {
     return clock_type::now() - last_tick_ >= interval_;
   }
 
   void tick(const scheduler_stats& stats)
+  {
+    tick(stats, {});
+  }
+
+  void tick(const scheduler_stats& stats, std::span<const scheduler_worker_stats> workers)
   {
     tick_ = clock_type::now();
     stats_ = stats;
 
+    prev_worker_stats_.swap(worker_stats_);
+    worker_stats_.assign(workers.begin(), workers.end());
+
+    // the worker set may change between runs; start over from zero in such case
+    if (prev_worker_stats_.size() != worker_stats_.size()) {
+      prev_worker_stats_.assign(worker_stats_.size(), scheduler_worker_stats{});
+    }
+
+    delta_worker_stats_.resize(worker_stats_.size());
+    for (std::size_t i = 0; i < worker_stats_.size(); ++i) {
+      delta_worker_stats_[i] = worker_stats_[i] - prev_worker_stats_[i];
+    }
+
     if (callback_ && stats_.count_updated(prev_stats_)) {
       delta_stats_ = scheduler_delta_stats{tick_ - last_tick_, prev_stats_, stats_};
       callback_(*this);
@@ -111,6 +181,8 @@ private:
 
   scheduler_stats stats_{}, prev_stats_{};
   scheduler_delta_stats delta_stats_{};
+
+  std::vector<scheduler_worker_stats> worker_stats_, prev_worker_stats_, delta_worker_stats_;
 };
 
 } // yk::exec
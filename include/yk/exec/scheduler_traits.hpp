@@ -29,6 +29,9 @@ struct scheduler_traits
   using producer_input_value_type = std::ranges::range_value_t<ProducerInputRangeT>;
   using producer_input_iterator = std::ranges::iterator_t<ProducerInputRangeT>;
 
+  // single-pass inputs are moved into a thread-local buffer before being passed to the producer
+  static constexpr bool is_streaming_input = !std::ranges::forward_range<ProducerInputRangeT>;
+
   using producer_gate_type = std::conditional_t<
     is_multi_push,
     counted_producer_gate<QueueT>,
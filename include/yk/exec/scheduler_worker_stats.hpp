@@ -0,0 +1,184 @@
+#ifndef YK_EXEC_SCHEDULER_WORKER_STATS_HPP
+#define YK_EXEC_SCHEDULER_WORKER_STATS_HPP
+
+#include "yk/exec/debug.hpp" // for ODR violation safety
+
+#include "yk/arch.hpp"
+#include "yk/chrono.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace yk::exec {
+
+// Accumulated wall time of a single worker, split by what the worker was doing.
+//
+//   busy     : inside producer/consumer functions, excluding queue operations
+//   queue    : inside queue operations (i.e. spinning or waiting on the queue)
+//   blocked  : waiting for the scheduler's internal locks
+//   switching: scheduler bookkeeping between jobs (chunk assignment, mode switch, ...)
+//
+// Time spent parked by the scaling policy is kept in parked_time and is not part of total_time().
+struct scheduler_worker_stats
+{
+  using duration_type = std::chrono::nanoseconds;
+
+  duration_type busy_time{}, queue_time{}, blocked_time{}, switch_time{};
+  duration_type parked_time{};
+
+  [[nodiscard]]
+  constexpr duration_type total_time() const noexcept
+  {
+    return busy_time + queue_time + blocked_time + switch_time;
+  }
+
+  // busy_time / total_time(); 0 if the worker has not run at all
+  [[nodiscard]]
+  constexpr double utilization() const noexcept
+  {
+    const auto total = total_time();
+    if (total == duration_type::zero()) return 0.0;
+    return yk::duration_cast<double, std::nano>(busy_time) / total;
+  }
+
+  [[nodiscard]]
+  friend constexpr scheduler_worker_stats operator-(const scheduler_worker_stats& lhs, const scheduler_worker_stats& rhs) noexcept
+  {
+    return {
+      .busy_time    = lhs.busy_time - rhs.busy_time,
+      .queue_time   = lhs.queue_time - rhs.queue_time,
+      .blocked_time = lhs.blocked_time - rhs.blocked_time,
+      .switch_time  = lhs.switch_time - rhs.switch_time,
+      .parked_time  = lhs.parked_time - rhs.parked_time,
+    };
+  }
+
+  constexpr scheduler_worker_stats& operator+=(const scheduler_worker_stats& other) noexcept
+  {
+    busy_time    += other.busy_time;
+    queue_time   += other.queue_time;
+    blocked_time += other.blocked_time;
+    switch_time  += other.switch_time;
+    parked_time  += other.parked_time;
+    return *this;
+  }
+};
+
+namespace detail {
+
+// Written only by the owning worker; read concurrently by the stats tracker.
+struct alignas(yk::hardware_destructive_interference_size) scheduler_worker_stats_counter
+{
+  using rep = scheduler_worker_stats::duration_type::rep;
+
+  void add(const scheduler_worker_stats& delta) noexcept
+  {
+    // single writer; plain load + store is enough to avoid a locked RMW
+    busy_ns.store(busy_ns.load(std::memory_order_relaxed) + delta.busy_time.count(), std::memory_order_relaxed);
+    queue_ns.store(queue_ns.load(std::memory_order_relaxed) + delta.queue_time.count(), std::memory_order_relaxed);
+    blocked_ns.store(blocked_ns.load(std::memory_order_relaxed) + delta.blocked_time.count(), std::memory_order_relaxed);
+    switch_ns.store(switch_ns.load(std::memory_order_relaxed) + delta.switch_time.count(), std::memory_order_relaxed);
+    parked_ns.store(parked_ns.load(std::memory_order_relaxed) + delta.parked_time.count(), std::memory_order_relaxed);
+  }
+
+  [[nodiscard]]
+  scheduler_worker_stats load() const noexcept
+  {
+    return {
+      .busy_time    = scheduler_worker_stats::duration_type{busy_ns.load(std::memory_order_relaxed)},
+      .queue_time   = scheduler_worker_stats::duration_type{queue_ns.load(std::memory_order_relaxed)},
+      .blocked_time = scheduler_worker_stats::duration_type{blocked_ns.load(std::memory_order_relaxed)},
+      .switch_time  = scheduler_worker_stats::duration_type{switch_ns.load(std::memory_order_relaxed)},
+      .parked_time  = scheduler_worker_stats::duration_type{parked_ns.load(std::memory_order_relaxed)},
+    };
+  }
+
+  std::atomic<rep> busy_ns{0}, queue_ns{0}, blocked_ns{0}, switch_ns{0}, parked_ns{0};
+};
+
+// Attributes the wall time between successive marks to each category,
+// then flushes the result to the worker's counter on destruction.
+class scheduler_worker_stats_recorder
+{
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  explicit scheduler_worker_stats_recorder(scheduler_worker_stats_counter* counter) noexcept
+    : counter_(counter)
+  {
+#if YK_EXEC_WORKER_STATS
+    if (counter_) last_ = clock_type::now();
+#endif
+  }
+
+  scheduler_worker_stats_recorder(const scheduler_worker_stats_recorder&) = delete;
+  scheduler_worker_stats_recorder& operator=(const scheduler_worker_stats_recorder&) = delete;
+
+  ~scheduler_worker_stats_recorder()
+  {
+#if YK_EXEC_WORKER_STATS
+    if (!counter_) return;
+    mark_switch();
+    counter_->add(stats_);
+#endif
+  }
+
+  // [[maybe_unused]] so that the signatures stay the same when YK_EXEC_WORKER_STATS=0
+  void mark_busy([[maybe_unused]] std::chrono::nanoseconds queue_time) noexcept
+  {
+#if YK_EXEC_WORKER_STATS
+    if (!counter_) return;
+    const auto elapsed = lap();
+    const auto queue = queue_time < elapsed ? queue_time : elapsed;
+    stats_.busy_time += elapsed - queue;
+    stats_.queue_time += queue;
+#endif
+  }
+
+  void mark_blocked() noexcept
+  {
+#if YK_EXEC_WORKER_STATS
+    if (!counter_) return;
+    stats_.blocked_time += lap();
+#endif
+  }
+
+  void mark_switch() noexcept
+  {
+#if YK_EXEC_WORKER_STATS
+    if (!counter_) return;
+    stats_.switch_time += lap();
+#endif
+  }
+
+  void mark_parked() noexcept
+  {
+#if YK_EXEC_WORKER_STATS
+    if (!counter_) return;
+    stats_.parked_time += lap();
+#endif
+  }
+
+private:
+#if YK_EXEC_WORKER_STATS
+  [[nodiscard]]
+  std::chrono::nanoseconds lap() noexcept
+  {
+    const auto now = clock_type::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_);
+    last_ = now;
+    return elapsed;
+  }
+
+  clock_type::time_point last_{};
+  scheduler_worker_stats stats_{};
+#endif
+
+  [[maybe_unused]] scheduler_worker_stats_counter* counter_;
+};
+
+} // detail
+
+} // yk::exec
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef YK_EXEC_WORKER_BUDGET_HPP
+#define YK_EXEC_WORKER_BUDGET_HPP
+
+#include "yk/exec/debug.hpp"// for ODR violation safety
+
+#include "yk/throwt.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+
+namespace yk::exec {
+
+// Caps the number of *running* workers, and the number of threads, across every
+// worker_pool sharing the budget.
+//
+// Workers take a slot while running and give it back when they park or exit.
+// A worker blocked in a queue gate or on its input is still running, so an idle
+// scheduler lends its share to the busy ones only if a scaling policy parks its
+// dynamic workers (see scheduler::set_scaling_policy). The fixed producer and
+// consumer of each scheduler take their two slots at once, before either runs.
+//
+// Threads are counted from launch to join. worker_pool::launch_rest() launches
+// only as many as the thread limit allows; threads that a pool must launch
+// (worker_pool::launch(), e.g. the fixed pair of each scheduler) are always
+// counted, so thread_count() may exceed the thread limit by those.
+class worker_budget
+{
+public:
+  worker_budget()
+    : worker_budget(static_cast<int>(std::max(2u, std::thread::hardware_concurrency())))
+  {}
+
+  // the thread limit defaults to twice the running limit, leaving room for parked workers to lend their slots
+  explicit worker_budget(int limit)
+  {
+    set_limit(limit);
+    thread_limit_ = 2 * limit;
+  }
+
+  worker_budget(const worker_budget&) = delete;
+  worker_budget& operator=(const worker_budget&) = delete;
+
+  // process-wide instance, limited to hardware_concurrency by default
+  [[nodiscard]]
+  static const std::shared_ptr<worker_budget>& global()
+  {
+    static const auto instance = std::make_shared<worker_budget>();
+    return instance;
+  }
+
+  // thread-safe
+  // the thread limit is raised to `limit` if it is lower
+  void set_limit(int limit)
+  {
+    if (limit < 2) {
+      throwt<std::invalid_argument>("worker budget must be >= 2");
+    }
+    {
+      std::unique_lock lock{mtx_};
+      limit_ = limit;
+      thread_limit_ = std::max(thread_limit_, limit);
+    }
+    cv_.notify_all();
+  }
+
+  // thread-safe
+  [[nodiscard]]
+  int get_limit() const
+  {
+    std::unique_lock lock{mtx_};
+    return limit_;
+  }
+
+  // thread-safe
+  [[nodiscard]]
+  int in_use() const
+  {
+    std::unique_lock lock{mtx_};
+    return in_use_;
+  }
+
+  // thread-safe
+  [[nodiscard]]
+  bool try_acquire(int count = 1)
+  {
+    std::unique_lock lock{mtx_};
+    return try_acquire_impl(count);
+  }
+
+  // thread-safe
+  // returns false on timeout or stop request
+  template <class Rep, class Period>
+  [[nodiscard]]
+  bool try_acquire_for(const std::stop_token& stop_token, const std::chrono::duration<Rep, Period>& timeout, int count = 1)
+  {
+    std::unique_lock lock{mtx_};
+    return cv_.wait_for(lock, stop_token, timeout, [&] { return try_acquire_impl(count); });
+  }
+
+  // thread-safe
+  // takes `count` slots at once; returns false on stop request, or once `cancel()` returns true.
+  // `cancel` is evaluated under the budget's lock, so it must not block; call notify_all() after
+  // making it true.
+  template <class Pred>
+  [[nodiscard]]
+  bool acquire(const std::stop_token& stop_token, int count, Pred&& cancel)
+  {
+    std::unique_lock lock{mtx_};
+    bool acquired = false;
+    cv_.wait(lock, stop_token, [&] {
+      if (try_acquire_impl(count)) return acquired = true;
+      return static_cast<bool>(cancel());
+    });
+    return acquired;
+  }
+
+  // thread-safe
+  void release(int count = 1)
+  {
+    {
+      std::unique_lock lock{mtx_};
+      in_use_ -= count;
+    }
+    cv_.notify_all();
+  }
+
+  // thread-safe
+  // wakes the threads blocked in acquire() so that they re-evaluate their `cancel` predicates
+  void notify_all()
+  {
+    {
+      std::unique_lock lock{mtx_}; // a waiter is either before its predicate or asleep
+    }
+    cv_.notify_all();
+  }
+
+  // --------------------------------
+
+  // thread-safe
+  void set_thread_limit(int thread_limit)
+  {
+    std::unique_lock lock{mtx_};
+    if (thread_limit < limit_) {
+      throwt<std::invalid_argument>("thread limit ({}) must be >= the worker budget ({})", thread_limit, limit_);
+    }
+    thread_limit_ = thread_limit;
+  }
+
+  // thread-safe
+  [[nodiscard]]
+  int get_thread_limit() const
+  {
+    std::unique_lock lock{mtx_};
+    return thread_limit_;
+  }
+
+  // thread-safe
+  [[nodiscard]]
+  int thread_count() const
+  {
+    std::unique_lock lock{mtx_};
+    return thread_count_;
+  }
+
+  // thread-safe
+  // counts a thread even if the thread limit is reached
+  void add_thread()
+  {
+    std::unique_lock lock{mtx_};
+    ++thread_count_;
+  }
+
+  // thread-safe
+  // counts up to `count` threads within the thread limit; returns how many were counted
+  [[nodiscard]]
+  int try_add_threads(int count)
+  {
+    std::unique_lock lock{mtx_};
+    const int granted = std::clamp(thread_limit_ - thread_count_, 0, count);
+    thread_count_ += granted;
+    return granted;
+  }
+
+  // thread-safe
+  void remove_thread()
+  {
+    std::unique_lock lock{mtx_};
+    --thread_count_;
+  }
+
+private:
+  // requires mtx_
+  bool try_acquire_impl(int count) noexcept
+  {
+    if (in_use_ + count > limit_) return false;
+    in_use_ += count;
+    return true;
+  }
+
+  mutable std::mutex mtx_;
+  std::condition_variable_any cv_;
+  int limit_ = 2;
+  int in_use_ = 0;
+  int thread_limit_ = 4;
+  int thread_count_ = 0;
+};
+
+// RAII holder of at most one slot; a null budget means unlimited
+class worker_budget_lease
+{
+public:
+  explicit worker_budget_lease(worker_budget* budget) noexcept
+    : budget_(budget)
+  {}
+
+  worker_budget_lease(const worker_budget_lease&) = delete;
+  worker_budget_lease& operator=(const worker_budget_lease&) = delete;
+
+  ~worker_budget_lease()
+  {
+    release();
+  }
+
+  [[nodiscard]]
+  bool held() const noexcept { return held_ || !budget_; }
+
+  [[nodiscard]]
+  bool try_acquire()
+  {
+    if (held()) return true;
+    return held_ = budget_->try_acquire();
+  }
+
+  // see worker_budget::acquire()
+  template <class Pred>
+  [[nodiscard]]
+  bool acquire(const std::stop_token& stop_token, Pred&& cancel)
+  {
+    if (held()) return true;
+    return held_ = budget_->acquire(stop_token, 1, std::forward<Pred>(cancel));
+  }
+
+  // takes over a slot acquired directly from the budget
+  void adopt() noexcept
+  {
+    if (budget_) held_ = true;
+  }
+
+  void release()
+  {
+    if (!held_) return;
+    budget_->release();
+    held_ = false;
+  }
+
+private:
+  worker_budget* budget_;
+  bool held_ = false;
+};
+
+} // yk::exec
+
+#endif
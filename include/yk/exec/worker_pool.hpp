@@ -3,14 +3,18 @@
 
 #include "yk/exec/debug.hpp"// for ODR violation safety
 #include "yk/exec/thread_index.hpp"
+#include "yk/exec/worker_budget.hpp"
 
 #include "yk/interrupt_exception.hpp"
 #include "yk/throwt.hpp"
 
 #include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stop_token>
 #include <thread>
-#include <vector>
 #include <stdexcept>
 #include <exception>
 
@@ -39,8 +43,24 @@ public:
   [[nodiscard]]
   int get_worker_limit() const noexcept { return worker_limit_; }
 
+  // thread-safe
   [[nodiscard]]
-  int launched_worker_count() const noexcept { return static_cast<int>(threads_.size()); }
+  int launched_worker_count() const noexcept
+  {
+    std::scoped_lock lock{threads_mtx_};
+    return static_cast<int>(threads_.size());
+  }
+
+  // not thread-safe
+  // share a budget (e.g. worker_budget::global()) between pools to cap the total number of running workers
+  // and threads; nullptr means unlimited. Schedulers lend idle workers' slots only if they have a scaling policy
+  void set_worker_budget(std::shared_ptr<worker_budget> budget) noexcept
+  {
+    worker_budget_ = std::move(budget);
+  }
+
+  [[nodiscard]]
+  const std::shared_ptr<worker_budget>& get_worker_budget() const noexcept { return worker_budget_; }
 
   [[nodiscard]]
   std::stop_token stop_token() const noexcept { return stop_source_.get_token(); }
@@ -54,13 +74,11 @@ public:
       return;
     }
 
-    for (auto& [thread, exception] : threads_) {
-      if (thread.joinable()) {
-        thread.join();
-      }
-      if (exception) {
-        auto ptr = exception;
-        exception = {};
+    for (std::size_t id = 0; ThreadData* data = thread_data(id); ++id) {
+      join_worker(*data);
+      if (data->exception) {
+        auto ptr = data->exception;
+        data->exception = {};
         std::rethrow_exception(ptr);
       }
     }
@@ -90,41 +108,105 @@ public:
     halt_and_clear_impl<false>();
   }
 
+  // thread-safe, but must not race with halt_and_clear() or rethrow_exceptions()
+  // waits for the given workers to return by themselves, without requesting stop; the other workers are left running.
+  // Joined workers at the end of the pool free their slots for later launches.
+  void join(std::span<const thread_index_t> worker_ids)
+  {
+    for (const auto id : worker_ids) {
+      if (ThreadData* data = thread_data(id)) {
+        join_worker(*data);
+      }
+    }
+
+    std::scoped_lock lock{threads_mtx_};
+    while (!threads_.empty() && threads_.back().joined) {
+      threads_.pop_back();
+    }
+  }
+
+  // thread-safe; workers may launch further workers
+  // counted by the worker budget even beyond its thread limit
   template <class F>
-  void launch(F&& f)
+  thread_index_t launch(F&& f)
   {
-    static_assert(std::invocable<F, thread_index_t, std::stop_token>);
+    if (worker_budget_) worker_budget_->add_thread();
+    return launch_counted(std::forward<F>(f));
+  }
 
-    threads_.emplace_back(std::thread{[
-      this,
-      id = static_cast<thread_index_t>(threads_.size()),
-      f = std::forward<F>(f)
-    ]() mutable {
-      try {
-        f(id, stop_source_.get_token());
+  // thread-safe
+  // launches up to the worker limit, within the worker budget's thread limit
+  template <class F>
+  void launch_rest(F&& f)
+  {
+    launch_rest_impl(f, [](thread_index_t) {});
+  }
 
-      } catch (const yk::interrupt_exception&) {
-        stop_source_.request_stop();
-        threads_[id].exception = std::current_exception();
+  // same as above, and appends the ids of the launched workers to `worker_ids`
+  template <class F, class Container>
+  void launch_rest(F&& f, Container& worker_ids)
+  {
+    launch_rest_impl(f, [&](const thread_index_t id) { worker_ids.push_back(id); });
+  }
 
+private:
+  template <class F, class OnLaunch>
+  void launch_rest_impl(F& f, OnLaunch&& on_launch)
+  {
+    int remaining = worker_limit_ - launched_worker_count();
+    if (remaining <= 0) return;
+    if (worker_budget_) remaining = worker_budget_->try_add_threads(remaining);
+
+    for (int i = 0; i < remaining; ++i) {
+      try {
+        on_launch(launch_counted(f));
       } catch (...) {
-        stop_source_.request_stop();
-        threads_[id].exception = std::current_exception();
+        if (worker_budget_) {
+          for (int j = i + 1; j < remaining; ++j) worker_budget_->remove_thread();
+        }
+        throw;
       }
-    }}, std::exception_ptr{});
+    }
   }
 
+  // the thread has been counted by the budget; uncounted again on failure or join
   template <class F>
-  void launch_rest(F&& f)
+  thread_index_t launch_counted(F&& f)
   {
-    const auto remaining = worker_limit_ - launched_worker_count();
+    static_assert(std::invocable<F, thread_index_t, std::stop_token>);
 
-    for (int i = 0; i < remaining; ++i) {
-      launch(f);
+    std::scoped_lock lock{threads_mtx_};
+    const auto id = static_cast<thread_index_t>(threads_.size());
+    // deque keeps `data` in place while other workers are launched
+    auto& data = threads_.emplace_back();
+    data.budget = worker_budget_;
+    try {
+      data.thread = std::thread{[
+        this,
+        &data,
+        id,
+        f = std::forward<F>(f)
+      ]() mutable {
+        try {
+          f(id, stop_source_.get_token());
+
+        } catch (const yk::interrupt_exception&) {
+          stop_source_.request_stop();
+          data.exception = std::current_exception();
+
+        } catch (...) {
+          stop_source_.request_stop();
+          data.exception = std::current_exception();
+        }
+      }};
+    } catch (...) {
+      threads_.pop_back();
+      if (worker_budget_) worker_budget_->remove_thread();
+      throw;
     }
+    return id;
   }
 
-private:
   template<bool IsExiting>
   void halt_and_clear_impl()
   {
@@ -133,21 +215,23 @@ private:
     [[maybe_unused]]
     std::exception_ptr first_exception;
 
-    for (auto& thread : threads_) {
-      if (!thread.thread.joinable()) {
+    // a joined worker can no longer launch others, so the pool is empty once the last one is joined
+    for (std::size_t id = 0; ThreadData* data = thread_data(id); ++id) {
+      if (!join_worker(*data)) {
         continue;
       }
 
-      thread.thread.join();
-
       if constexpr (IsExiting) {
-        if (rethrow_exceptions_on_exit_ && thread.exception) {
-          first_exception = thread.exception;
+        if (rethrow_exceptions_on_exit_ && data->exception) {
+          first_exception = data->exception;
         }
       }
     }
 
-    threads_.clear();
+    {
+      std::scoped_lock lock{threads_mtx_};
+      threads_.clear();
+    }
 
     if constexpr (IsExiting) {
       if (first_exception) {
@@ -157,13 +241,48 @@ private:
   }
 
   int worker_limit_ = 2;
+  std::shared_ptr<worker_budget> worker_budget_;
 
   struct ThreadData
   {
     std::thread thread;
     std::exception_ptr exception;
+    std::shared_ptr<worker_budget> budget; // counts the thread until joined
+    bool joined = false; // guarded by threads_mtx_
   };
-  std::vector<ThreadData> threads_;
+
+  [[nodiscard]]
+  ThreadData* thread_data(std::size_t id) noexcept
+  {
+    std::scoped_lock lock{threads_mtx_};
+    return id < threads_.size() ? &threads_[id] : nullptr;
+  }
+
+  // joins outside the lock so that the worker can still launch others meanwhile;
+  // returns false if the worker has already been taken by another join
+  bool join_worker(ThreadData& data)
+  {
+    std::thread thread;
+    {
+      std::scoped_lock lock{threads_mtx_};
+      thread = std::move(data.thread);
+    }
+    if (!thread.joinable()) {
+      return false;
+    }
+    thread.join();
+
+    std::scoped_lock lock{threads_mtx_};
+    data.joined = true;
+    if (data.budget) {
+      data.budget->remove_thread();
+      data.budget.reset();
+    }
+    return true;
+  }
+
+  mutable std::mutex threads_mtx_;
+  std::deque<ThreadData> threads_;
   std::stop_source stop_source_;
 
   bool rethrow_exceptions_on_exit_ = true;
@@ -27,8 +27,10 @@ enum struct consumer_kind : bool
   multi_pop,
 };
 
+// forward ranges are split into chunks by iterator copies;
+// single-pass input ranges (e.g. std::generator) are pulled and moved chunk by chunk
 template <class R>
-concept ProducerInputRange = std::ranges::forward_range<R>;
+concept ProducerInputRange = std::ranges::input_range<R>;
 
 template <class F, class ProducerInputRangeT, class GateT>
 concept Producer =
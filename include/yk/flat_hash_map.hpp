@@ -0,0 +1,132 @@
+#ifndef YK_FLAT_HASH_MAP_HPP
+#define YK_FLAT_HASH_MAP_HPP
+
+#include "yk/detail/raw_hash_table.hpp"
+#include "yk/throwt.hpp"
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace yk {
+
+namespace detail {
+
+template <class Key, class T>
+struct flat_map_policy {
+  using key_type = Key;
+  using value_type = std::pair<const Key, T>;
+  using init_type = std::pair<Key, T>;
+
+  static constexpr bool constant_iterators = false;
+
+  template <class Pair>
+  [[nodiscard]] static const Key& key(const Pair& p) noexcept {
+    return p.first;
+  }
+
+  // the source is destroyed right after, so its key may be moved from
+  template <class Alloc>
+  static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+    std::allocator_traits<Alloc>::construct(alloc, dst, std::move(const_cast<Key&>(src->first)), std::move(src->second));
+    std::allocator_traits<Alloc>::destroy(alloc, src);
+  }
+};
+
+}  // namespace detail
+
+// Open-addressing hash map (SwissTable layout, see detail/raw_hash_table.hpp).
+// Differences from std::unordered_map:
+//   - elements are stored inline; any insertion may move them and invalidates every iterator and reference
+//   - the max load factor is fixed at 7/8, and there is no bucket interface beyond bucket_count()
+//   - heterogeneous lookup when both Hash and KeyEqual are transparent (e.g. yk::string_hash with std::equal_to<>)
+//   - hashes are post-mixed unless Hash::is_avalanching exists
+template <class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<std::pair<const Key, T>>>
+class flat_hash_map : public detail::raw_hash_table<detail::flat_map_policy<Key, T>, Hash, KeyEqual, Allocator> {
+  using base_type = detail::raw_hash_table<detail::flat_map_policy<Key, T>, Hash, KeyEqual, Allocator>;
+
+  static constexpr bool is_transparent = detail::transparent_hash_table<Hash, KeyEqual>;
+
+public:
+  using mapped_type = T;
+  using typename base_type::const_iterator;
+  using typename base_type::iterator;
+  using typename base_type::key_type;
+  using typename base_type::size_type;
+  using typename base_type::value_type;
+
+  using base_type::base_type;
+  using base_type::operator=;
+
+  flat_hash_map() = default;
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    return this->emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+    return this->emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  // the key is converted to key_type only when it is inserted
+  template <class K, class... Args>
+    requires is_transparent && (!std::is_convertible_v<K, const_iterator>) && (!std::is_convertible_v<K, iterator>)
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return this->emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  template <class M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+    auto result = try_emplace(key, std::forward<M>(obj));
+    if (!result.second) result.first->second = std::forward<M>(obj);
+    return result;
+  }
+
+  template <class M>
+  std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+    auto result = try_emplace(std::move(key), std::forward<M>(obj));
+    if (!result.second) result.first->second = std::forward<M>(obj);
+    return result;
+  }
+
+  T& operator[](const key_type& key) { return try_emplace(key).first->second; }
+  T& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+  template <class K>
+    requires is_transparent
+  T& operator[](K&& key) {
+    return try_emplace(std::forward<K>(key)).first->second;
+  }
+
+  [[nodiscard]] T& at(const key_type& key) { return at_impl(*this, key); }
+  [[nodiscard]] const T& at(const key_type& key) const { return at_impl(*this, key); }
+
+  template <class K>
+    requires is_transparent
+  [[nodiscard]] T& at(const K& key) {
+    return at_impl(*this, key);
+  }
+
+  template <class K>
+    requires is_transparent
+  [[nodiscard]] const T& at(const K& key) const {
+    return at_impl(*this, key);
+  }
+
+private:
+  template <class Self, class K>
+  [[nodiscard]] static auto& at_impl(Self& self, const K& key) {
+    const auto it = self.find(key);
+    if (it == self.end()) throwt<std::out_of_range>("flat_hash_map::at: key not found");
+    return it->second;
+  }
+};
+
+}  // namespace yk
+
+#endif  // YK_FLAT_HASH_MAP_HPP
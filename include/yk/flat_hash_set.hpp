@@ -0,0 +1,47 @@
+#ifndef YK_FLAT_HASH_SET_HPP
+#define YK_FLAT_HASH_SET_HPP
+
+#include "yk/detail/raw_hash_table.hpp"
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace yk {
+
+namespace detail {
+
+template <class Key>
+struct flat_set_policy {
+  using key_type = Key;
+  using value_type = Key;
+  using init_type = Key;
+
+  static constexpr bool constant_iterators = true;
+
+  [[nodiscard]] static const Key& key(const Key& k) noexcept { return k; }
+
+  template <class Alloc>
+  static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+    std::allocator_traits<Alloc>::construct(alloc, dst, std::move(*src));
+    std::allocator_traits<Alloc>::destroy(alloc, src);
+  }
+};
+
+}  // namespace detail
+
+// Open-addressing hash set; see flat_hash_map for the differences from the std counterpart.
+template <class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>, class Allocator = std::allocator<Key>>
+class flat_hash_set : public detail::raw_hash_table<detail::flat_set_policy<Key>, Hash, KeyEqual, Allocator> {
+  using base_type = detail::raw_hash_table<detail::flat_set_policy<Key>, Hash, KeyEqual, Allocator>;
+
+public:
+  using base_type::base_type;
+  using base_type::operator=;
+
+  flat_hash_set() = default;
+};
+
+}  // namespace yk
+
+#endif  // YK_FLAT_HASH_SET_HPP
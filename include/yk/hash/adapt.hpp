@@ -1,6 +1,7 @@
 #ifndef YK_HASH_ADAPT_HPP
 #define YK_HASH_ADAPT_HPP
 
+#include "yk/hash/hash_append.hpp"
 #include "yk/hash/hash_value_for.hpp"
 
 #define YK_PP_REQUIRE_SEMICOLON static_assert(true)
@@ -43,4 +44,33 @@
   } /* ns */                                                                                                                   \
   YK_PP_REQUIRE_SEMICOLON
 
+// Adapts `type` to the hash_append protocol by appending the given expressions of `param`;
+// std::hash and hash_value then finalize once through yk::uhash<>.
+//   YK_ADAPT_HASH_APPEND(ns, type, x, x.a, x.b, x.c);
+#define YK_ADAPT_HASH_APPEND(ns, type, param, ...)                                             \
+  namespace ns {                                                                               \
+  template <class HashAlgorithm>                                                               \
+  inline void hash_append(HashAlgorithm& h, type const& param) noexcept /* strengthened */     \
+  {                                                                                            \
+    using ::yk::hash_append;                                                                   \
+    hash_append(h, __VA_ARGS__);                                                               \
+  }                                                                                            \
+                                                                                               \
+  [[nodiscard]] inline std::size_t hash_value(type const& value) noexcept /* strengthened */   \
+  {                                                                                            \
+    return ::yk::uhash<>{}(value);                                                             \
+  }                                                                                            \
+  } /* ns */                                                                                   \
+                                                                                               \
+  namespace std {                                                                              \
+  template <>                                                                                  \
+  struct hash<::ns::type> {                                                                    \
+    inline size_t operator()(::ns::type const& value) const noexcept /* strengthened */        \
+    {                                                                                          \
+      return ::yk::uhash<>{}(value);                                                           \
+    }                                                                                          \
+  };                                                                                           \
+  } /* std */                                                                                  \
+  YK_PP_REQUIRE_SEMICOLON
+
 #endif  // YK_HASH_ADAPT_HPP
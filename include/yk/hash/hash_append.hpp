@@ -0,0 +1,111 @@
+#ifndef YK_HASH_HASH_APPEND_HPP
+#define YK_HASH_HASH_APPEND_HPP
+
+#include "yk/hash/hash_value_for.hpp"
+#include "yk/hash/hasher.hpp"
+#include "yk/hash/range.hpp"
+
+#include "yk/util/specialization_of.hpp"
+
+#include <bit>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <cstddef>
+#include <cstdint>
+
+// N3980 hash_append: a value feeds its bytes into a streaming hasher instead of
+// producing its own size_t, so a composite key is finalized exactly once.
+//
+// A type opts in by providing, in its namespace,
+//   template <class HashAlgorithm>
+//   void hash_append(HashAlgorithm& h, const T& x) noexcept { using yk::hash_append; hash_append(h, x.a, x.b); }
+// (or YK_ADAPT_HASH_APPEND); types that only have std::hash / hash_value append that size_t.
+
+namespace yk {
+
+template <class HashAlgorithm, class T>
+void hash_append(HashAlgorithm& h, const T& x) noexcept;
+
+template <class HashAlgorithm, class T, class U, class... Ts>
+void hash_append(HashAlgorithm& h, const T& x, const U& y, const Ts&... xs) noexcept {
+  hash_append(h, x);
+  hash_append(h, y);
+  (hash_append(h, xs), ...);
+}
+
+template <class HashAlgorithm, class T>
+void hash_append(HashAlgorithm& h, const T& x) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    // +0.0 == -0.0
+    const T normalized = x == T{} ? T{} : x;
+    // the bytes are hashed only if the value bits fill the object; e.g. x87 long double has 6 bytes of padding
+    if constexpr (sizeof(T) == sizeof(std::uint32_t) && std::numeric_limits<T>::is_iec559) {
+      const auto bits = std::bit_cast<std::uint32_t>(normalized);
+      h(std::addressof(bits), sizeof(bits));
+    } else if constexpr (sizeof(T) == sizeof(std::uint64_t) && std::numeric_limits<T>::is_iec559) {
+      const auto bits = std::bit_cast<std::uint64_t>(normalized);
+      h(std::addressof(bits), sizeof(bits));
+    } else {
+      hash_append(h, static_cast<std::size_t>(::yk::hash_value_for(normalized)));
+    }
+
+  } else if constexpr (std::is_scalar_v<T> && std::has_unique_object_representations_v<T>) {
+    h(std::addressof(x), sizeof(x));
+
+  } else if constexpr (std::is_null_pointer_v<T>) {
+    constexpr unsigned char zero = 0;
+    h(&zero, 1);
+
+  } else if constexpr (std::ranges::range<const T&>) {
+    // the size goes last, so that {"ab", "c"} and {"a", "bc"} differ
+    // (only scalars are appended in bulk; a class may hash fewer members than its bytes)
+    if constexpr (detail::bytewise_hashable_range<const T&> && std::is_scalar_v<std::ranges::range_value_t<const T&>>) {
+      h(std::ranges::data(x), std::ranges::size(x) * sizeof(std::ranges::range_value_t<const T&>));
+    } else {
+      for (const auto& elem : x) hash_append(h, elem);
+    }
+    hash_append(h, static_cast<std::size_t>(std::ranges::distance(x)));
+
+  } else if constexpr (specialization_of<T, std::optional>) {
+    hash_append(h, x.has_value());
+    if (x) hash_append(h, *x);
+
+  } else if constexpr (specialization_of<T, std::variant>) {
+    hash_append(h, x.index());
+    if (!x.valueless_by_exception()) std::visit([&](const auto& alt) { hash_append(h, alt); }, x);
+
+  } else if constexpr (requires { std::tuple_size<T>::value; }) {
+    std::apply([&](const auto&... elems) { (hash_append(h, elems), ...); }, x);
+
+  } else {
+    // YK_ADAPT_HASH, std::hash, hash_value, ...
+    hash_append(h, static_cast<std::size_t>(::yk::hash_value_for(x)));
+  }
+}
+
+// Hash functor for unordered containers; each call starts from a copy of `hasher`
+// (e.g. a keyed siphash) and finalizes once.
+template <class HashAlgorithm = wyhash>
+struct uhash {
+  using result_type = typename HashAlgorithm::result_type;
+
+  HashAlgorithm hasher{};
+
+  template <class T>
+  [[nodiscard]] std::size_t operator()(const T& x) const noexcept {
+    HashAlgorithm h = hasher;
+    hash_append(h, x);
+    return static_cast<std::size_t>(static_cast<result_type>(h));
+  }
+};
+
+}  // namespace yk
+
+#endif  // YK_HASH_HASH_APPEND_HPP
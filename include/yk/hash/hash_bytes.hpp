@@ -0,0 +1,108 @@
+#ifndef YK_HASH_HASH_BYTES_HPP
+#define YK_HASH_HASH_BYTES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace yk {
+
+namespace detail::wyhash {
+
+// 64x64 -> 128 bit multiply; returns the low half in a and the high half in b
+inline void mum(std::uint64_t& a, std::uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+  __extension__ using uint128_t = unsigned __int128;  // silences -pedantic
+  const auto r = static_cast<uint128_t>(a) * b;
+  a = static_cast<std::uint64_t>(r);
+  b = static_cast<std::uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+  a = _umul128(a, b, &b);
+#else
+  const std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+  const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+  std::uint64_t lo = t + (rm1 << 32);
+  std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+  a = lo;
+  b = hi;
+#endif
+}
+
+[[nodiscard]] inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+  mum(a, b);
+  return a ^ b;
+}
+
+// native byte order: the result is deterministic within a process, not across architectures
+[[nodiscard]] inline std::uint64_t read8(const unsigned char* p) noexcept {
+  std::uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+[[nodiscard]] inline std::uint64_t read4(const unsigned char* p) noexcept {
+  std::uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+// 1 <= k <= 3
+[[nodiscard]] inline std::uint64_t read3(const unsigned char* p, std::size_t k) noexcept {
+  return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[k >> 1]} << 8) | p[k - 1];
+}
+
+inline constexpr std::uint64_t secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+}  // namespace detail::wyhash
+
+// wyhash (final4). Inputs longer than 48 bytes are consumed by three independent
+// multiply lanes per iteration, so the loop is bound by multiplier throughput, not latency.
+[[nodiscard]] inline std::uint64_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) noexcept {
+  using namespace detail::wyhash;
+
+  const auto* p = static_cast<const unsigned char*>(data);
+  seed ^= mix(seed ^ secret[0], secret[1]);
+
+  std::uint64_t a = 0, b = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+      b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = read3(p, len);
+    }
+  } else {
+    std::size_t i = len;
+    if (i > 48) {
+      std::uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+        see1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+        see2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+
+  a ^= secret[1];
+  b ^= seed;
+  mum(a, b);
+  return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+}  // namespace yk
+
+#endif  // YK_HASH_HASH_BYTES_HPP
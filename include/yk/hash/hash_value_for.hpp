@@ -32,6 +32,14 @@ template <class T>
   }
 }
 
+// hash_value_for as a function object, e.g. for the Hash parameter of a container
+struct hash_value_for_fn {
+  template <class T>
+  [[nodiscard]] std::size_t operator()(const T& x) const noexcept {
+    return ::yk::hash_value_for(x);
+  }
+};
+
 }  // namespace yk
 
 #endif  // YK_HASH_HASH_VALUE_FOR_HPP
@@ -0,0 +1,213 @@
+#ifndef YK_HASH_HASHER_HPP
+#define YK_HASH_HASHER_HPP
+
+#include "yk/hash/hash_bytes.hpp"
+
+#include <algorithm>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Streaming hashers for the hash_append protocol (N3980):
+//   h(const void* data, std::size_t len)  appends bytes
+//   static_cast<result_type>(h)           finalizes
+
+namespace yk {
+
+// FNV-1a, 64 bit. Cheapest per byte for short keys; weak against adversarial input.
+class fnv1a {
+public:
+  using result_type = std::uint64_t;
+
+  constexpr fnv1a() noexcept = default;
+
+  void operator()(const void* data, std::size_t len) noexcept {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < len; ++i) {
+      state_ = (state_ ^ p[i]) * prime;
+    }
+  }
+
+  explicit operator result_type() const noexcept { return state_; }
+
+private:
+  static constexpr std::uint64_t offset_basis = 14695981039346656037ull;
+  static constexpr std::uint64_t prime = 1099511628211ull;
+
+  std::uint64_t state_ = offset_basis;
+};
+
+// Streaming wyhash; the result for a byte sequence is the same as hash_bytes(),
+// however the sequence is split into calls.
+class wyhash {
+public:
+  using result_type = std::uint64_t;
+
+  explicit wyhash(std::uint64_t seed = 0) noexcept {
+    using namespace detail::wyhash;
+    seed_ = seed ^ mix(seed ^ secret[0], secret[1]);
+    see1_ = see2_ = seed_;
+  }
+
+  void operator()(const void* data, std::size_t len) noexcept {
+    const auto* p = static_cast<const unsigned char*>(data);
+    total_ += len;
+
+    while (len > 0) {
+      if (pending_ == block_size) {
+        consume_block(buf_ + history_size);
+        std::memcpy(buf_, buf_ + block_size, history_size);
+        pending_ = 0;
+      }
+      // large input: consume straight from the caller's buffer, keeping at least one byte for finalization
+      if (pending_ == 0 && len > block_size) {
+        do {
+          consume_block(p);
+          p += block_size;
+          len -= block_size;
+        } while (len > block_size);
+        std::memcpy(buf_, p - history_size, history_size);
+      }
+      const auto n = std::min(len, block_size - pending_);
+      std::memcpy(buf_ + history_size + pending_, p, n);
+      pending_ += n;
+      p += n;
+      len -= n;
+    }
+  }
+
+  explicit operator result_type() const noexcept {
+    using namespace detail::wyhash;
+
+    const unsigned char* p = buf_ + history_size;
+    std::uint64_t a = 0, b = 0;
+    std::uint64_t seed = seed_;
+
+    if (total_ <= 16) {
+      const auto len = pending_;
+      if (len >= 4) {
+        a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+        b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+      } else if (len > 0) {
+        a = read3(p, len);
+      }
+    } else {
+      if (has_blocks_) seed ^= see1_ ^ see2_;
+      std::size_t i = pending_;
+      while (i > 16) {
+        seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+        i -= 16;
+        p += 16;
+      }
+      // may reach back into the history bytes
+      a = read8(p + i - 16);
+      b = read8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    mum(a, b);
+    return mix(a ^ secret[0] ^ total_, b ^ secret[1]);
+  }
+
+private:
+  static constexpr std::size_t block_size = 48;
+  static constexpr std::size_t history_size = 16;
+
+  void consume_block(const unsigned char* p) noexcept {
+    using namespace detail::wyhash;
+    seed_ = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed_);
+    see1_ = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1_);
+    see2_ = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2_);
+    has_blocks_ = true;
+  }
+
+  std::uint64_t seed_, see1_, see2_;
+  std::uint64_t total_ = 0;
+  std::size_t pending_ = 0;
+  bool has_blocks_ = false;
+
+  // [0, 16): the last bytes already consumed, [16, 16 + pending_): the bytes not consumed yet
+  unsigned char buf_[history_size + block_size]{};
+};
+
+// SipHash-2-4 with a 128 bit key. Use it with a secret key for keys an attacker controls.
+class siphash {
+public:
+  using result_type = std::uint64_t;
+
+  explicit siphash(std::uint64_t k0 = 0, std::uint64_t k1 = 0) noexcept
+      : v0_(0x736f6d6570736575ull ^ k0), v1_(0x646f72616e646f6dull ^ k1), v2_(0x6c7967656e657261ull ^ k0), v3_(0x7465646279746573ull ^ k1) {}
+
+  void operator()(const void* data, std::size_t len) noexcept {
+    const auto* p = static_cast<const unsigned char*>(data);
+    total_ += len;
+
+    if (pending_ != 0) {
+      const auto n = std::min(len, 8 - pending_);
+      std::memcpy(buf_ + pending_, p, n);
+      pending_ += n;
+      p += n;
+      len -= n;
+      if (pending_ < 8) return;
+      compress(detail::wyhash::read8(buf_));
+      pending_ = 0;
+    }
+    for (; len >= 8; p += 8, len -= 8) {
+      compress(detail::wyhash::read8(p));
+    }
+    std::memcpy(buf_, p, len);
+    pending_ = len;
+  }
+
+  explicit operator result_type() const noexcept {
+    siphash s = *this;
+    std::uint64_t last = static_cast<std::uint64_t>(total_ & 0xff) << 56;
+    for (std::size_t i = 0; i < pending_; ++i) last |= static_cast<std::uint64_t>(buf_[i]) << (8 * i);
+    s.compress(last);
+
+    s.v2_ ^= 0xff;
+    s.round();
+    s.round();
+    s.round();
+    s.round();
+    return s.v0_ ^ s.v1_ ^ s.v2_ ^ s.v3_;
+  }
+
+private:
+  [[nodiscard]] static constexpr std::uint64_t rotl(std::uint64_t x, int b) noexcept { return (x << b) | (x >> (64 - b)); }
+
+  void round() noexcept {
+    v0_ += v1_;
+    v1_ = rotl(v1_, 13);
+    v1_ ^= v0_;
+    v0_ = rotl(v0_, 32);
+    v2_ += v3_;
+    v3_ = rotl(v3_, 16);
+    v3_ ^= v2_;
+    v0_ += v3_;
+    v3_ = rotl(v3_, 21);
+    v3_ ^= v0_;
+    v2_ += v1_;
+    v1_ = rotl(v1_, 17);
+    v1_ ^= v2_;
+    v2_ = rotl(v2_, 32);
+  }
+
+  void compress(std::uint64_t m) noexcept {
+    v3_ ^= m;
+    round();
+    round();
+    v0_ ^= m;
+  }
+
+  std::uint64_t v0_, v1_, v2_, v3_;
+  std::uint64_t total_ = 0;
+  std::size_t pending_ = 0;
+  unsigned char buf_[8]{};
+};
+
+}  // namespace yk
+
+#endif  // YK_HASH_HASHER_HPP
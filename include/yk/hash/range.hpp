@@ -1,9 +1,12 @@
 #ifndef YK_HASH_RANGE_HPP
 #define YK_HASH_RANGE_HPP
 
+#include "yk/hash/hash_bytes.hpp"
+
 #include <boost/container_hash/hash_fwd.hpp>
 
 #include <ranges>
+#include <type_traits>
 #include <utility>
 
 #include <cassert>
@@ -11,11 +14,27 @@
 
 namespace yk {
 
+namespace detail {
+
+// equal values have equal bytes, so the bytes can be hashed instead of the values
+template <class R>
+concept bytewise_hashable_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && std::is_trivially_copyable_v<std::ranges::range_value_t<R>> &&
+    std::has_unique_object_representations_v<std::ranges::range_value_t<R>>;
+
+}  // namespace detail
+
+// Contiguous ranges of uniquely-represented values are hashed in bulk with hash_bytes;
+// the others fold each element through boost::hash_combine.
 template <std::ranges::range R>
 [[nodiscard]] inline std::size_t hash_range(R&& r) noexcept {
-  std::size_t seed = 0;
-  for (auto&& elem : r) boost::hash_combine(seed, elem);
-  return seed;
+  if constexpr (detail::bytewise_hashable_range<R>) {
+    return static_cast<std::size_t>(hash_bytes(std::ranges::data(r), std::ranges::size(r) * sizeof(std::ranges::range_value_t<R>)));
+  } else {
+    std::size_t seed = 0;
+    for (auto&& elem : r) boost::hash_combine(seed, elem);
+    return seed;
+  }
 }
 
 }  // namespace yk
@@ -6,7 +6,11 @@
 
 #if __cpp_lib_parallel_algorithm >= 201603L
 
+#include <atomic>
+#include <concepts>
 #include <execution>
+#include <shared_mutex>  // IWYU pragma: keep
+#include <type_traits>
 
 namespace yk {
 
@@ -22,9 +26,41 @@ struct is_parallel<std::execution::sequenced_policy> : std::false_type {};
 template <>
 struct is_parallel<std::execution::parallel_policy> : std::true_type {};
 
+template <>
+struct is_parallel<std::execution::parallel_unsequenced_policy> : std::true_type {};
+
+#if __cpp_lib_execution >= 201902L
+template <>
+struct is_parallel<std::execution::unsequenced_policy> : std::false_type {};
+#endif
+
 template <class Policy>
 constexpr bool is_parallel_v = is_parallel<Policy>::value;
 
+// Element accesses may be interleaved on one thread (SIMD lanes), so only
+// vectorization-safe, lock-free operations are allowed; a mutex would deadlock.
+template <class Policy>
+struct is_vectorized {
+  static_assert(std::is_execution_policy_v<Policy>, "Policy must be execution policy");
+};
+
+template <>
+struct is_vectorized<std::execution::sequenced_policy> : std::false_type {};
+
+template <>
+struct is_vectorized<std::execution::parallel_policy> : std::false_type {};
+
+template <>
+struct is_vectorized<std::execution::parallel_unsequenced_policy> : std::true_type {};
+
+#if __cpp_lib_execution >= 201902L
+template <>
+struct is_vectorized<std::execution::unsequenced_policy> : std::true_type {};
+#endif
+
+template <class Policy>
+constexpr bool is_vectorized_v = is_vectorized<Policy>::value;
+
 namespace xo {  // exposition only
 
 // https://en.cppreference.com/w/cpp/named_req/BasicLockable
@@ -40,21 +76,32 @@ concept Lockable = BasicLockable<M> && requires(M& m) {
   { m.try_lock() } -> std::convertible_to<bool>;
 };
 
+// https://en.cppreference.com/w/cpp/named_req/SharedLockable
+template <class M>
+concept SharedLockable = requires(M& m) {
+  m.lock_shared();
+  m.unlock_shared();
+  { m.try_lock_shared() } -> std::convertible_to<bool>;
+};
+
 }  // namespace xo
 
+// Mutex under parallel policies, no-op under sequenced ones.
+// Not available under par_unseq or unseq: locking is vectorization-unsafe there; use maybe_atomic instead.
 template <class Mutex, class Policy>
 class maybe_mutex;
 
 template <class Mutex, class Policy>
-  requires is_parallel_v<Policy>
+  requires is_parallel_v<Policy> || is_vectorized_v<Policy>
 class maybe_mutex<Mutex, Policy> : public Mutex {
 public:
   static_assert(xo::Lockable<Mutex>);
+  static_assert(!is_vectorized_v<Policy>, "mutexes must not be used under vectorized policies");
   using Mutex::Mutex;
 };
 
 template <class Mutex, class Policy>
-  requires (!is_parallel_v<Policy>)
+  requires (!is_parallel_v<Policy> && !is_vectorized_v<Policy>)
 class maybe_mutex<Mutex, Policy> {
 public:
   static_assert(xo::Lockable<Mutex>);
@@ -64,6 +111,144 @@ public:
   [[nodiscard]] constexpr bool try_lock() const noexcept { return true; }
 };
 
+template <class SharedMutex, class Policy>
+class maybe_shared_mutex;
+
+template <class SharedMutex, class Policy>
+  requires is_parallel_v<Policy> || is_vectorized_v<Policy>
+class maybe_shared_mutex<SharedMutex, Policy> : public SharedMutex {
+public:
+  static_assert(xo::Lockable<SharedMutex> && xo::SharedLockable<SharedMutex>);
+  static_assert(!is_vectorized_v<Policy>, "mutexes must not be used under vectorized policies");
+  using SharedMutex::SharedMutex;
+};
+
+template <class SharedMutex, class Policy>
+  requires (!is_parallel_v<Policy> && !is_vectorized_v<Policy>)
+class maybe_shared_mutex<SharedMutex, Policy> {
+public:
+  static_assert(xo::Lockable<SharedMutex> && xo::SharedLockable<SharedMutex>);
+
+  constexpr void lock() const noexcept {}
+  constexpr void unlock() const noexcept {}
+  [[nodiscard]] constexpr bool try_lock() const noexcept { return true; }
+
+  constexpr void lock_shared() const noexcept {}
+  constexpr void unlock_shared() const noexcept {}
+  [[nodiscard]] constexpr bool try_lock_shared() const noexcept { return true; }
+};
+
+// std::atomic<T> under parallel and vectorized policies, a plain value with the same interface under sequenced ones.
+// Under par_unseq and unseq, T must be lock-free.
+template <class T, class Policy>
+class maybe_atomic;
+
+template <class T, class Policy>
+  requires is_parallel_v<Policy> || is_vectorized_v<Policy>
+class maybe_atomic<T, Policy> : public std::atomic<T> {
+public:
+  static_assert(!is_vectorized_v<Policy> || std::atomic<T>::is_always_lock_free,
+                "atomics under vectorized policies must be lock-free");
+  using std::atomic<T>::atomic;
+  using std::atomic<T>::operator=;
+};
+
+template <class T, class Policy>
+  requires (!is_parallel_v<Policy> && !is_vectorized_v<Policy>)
+class maybe_atomic<T, Policy> {
+public:
+  using value_type = T;
+
+  static constexpr bool is_always_lock_free = true;
+
+  constexpr maybe_atomic() noexcept(std::is_nothrow_default_constructible_v<T>) = default;
+  constexpr maybe_atomic(T desired) noexcept : value_(desired) {}
+  maybe_atomic(const maybe_atomic&) = delete;
+  maybe_atomic& operator=(const maybe_atomic&) = delete;
+
+  constexpr T operator=(T desired) noexcept { return value_ = desired; }
+  constexpr operator T() const noexcept { return value_; }
+
+  [[nodiscard]] constexpr bool is_lock_free() const noexcept { return true; }
+
+  [[nodiscard]] constexpr T load(std::memory_order = std::memory_order_seq_cst) const noexcept { return value_; }
+  constexpr void store(T desired, std::memory_order = std::memory_order_seq_cst) noexcept { value_ = desired; }
+
+  constexpr T exchange(T desired, std::memory_order = std::memory_order_seq_cst) noexcept {
+    T old = value_;
+    value_ = desired;
+    return old;
+  }
+
+  constexpr bool compare_exchange_strong(T& expected, T desired, std::memory_order = std::memory_order_seq_cst) noexcept {
+    if (value_ == expected) {
+      value_ = desired;
+      return true;
+    }
+    expected = value_;
+    return false;
+  }
+  constexpr bool compare_exchange_strong(T& expected, T desired, std::memory_order, std::memory_order) noexcept {
+    return compare_exchange_strong(expected, desired);
+  }
+  constexpr bool compare_exchange_weak(T& expected, T desired, std::memory_order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_strong(expected, desired);
+  }
+  constexpr bool compare_exchange_weak(T& expected, T desired, std::memory_order, std::memory_order) noexcept {
+    return compare_exchange_strong(expected, desired);
+  }
+
+  constexpr T fetch_add(T arg, std::memory_order = std::memory_order_seq_cst) noexcept
+    requires std::integral<T> || std::floating_point<T>
+  {
+    T old = value_;
+    value_ += arg;
+    return old;
+  }
+  constexpr T fetch_sub(T arg, std::memory_order = std::memory_order_seq_cst) noexcept
+    requires std::integral<T> || std::floating_point<T>
+  {
+    T old = value_;
+    value_ -= arg;
+    return old;
+  }
+  constexpr T fetch_and(T arg, std::memory_order = std::memory_order_seq_cst) noexcept
+    requires std::integral<T>
+  {
+    T old = value_;
+    value_ &= arg;
+    return old;
+  }
+  constexpr T fetch_or(T arg, std::memory_order = std::memory_order_seq_cst) noexcept
+    requires std::integral<T>
+  {
+    T old = value_;
+    value_ |= arg;
+    return old;
+  }
+  constexpr T fetch_xor(T arg, std::memory_order = std::memory_order_seq_cst) noexcept
+    requires std::integral<T>
+  {
+    T old = value_;
+    value_ ^= arg;
+    return old;
+  }
+
+  constexpr T operator++() noexcept requires std::integral<T> { return ++value_; }
+  constexpr T operator++(int) noexcept requires std::integral<T> { return value_++; }
+  constexpr T operator--() noexcept requires std::integral<T> { return --value_; }
+  constexpr T operator--(int) noexcept requires std::integral<T> { return value_--; }
+
+  constexpr T operator+=(T arg) noexcept requires std::integral<T> || std::floating_point<T> { return value_ += arg; }
+  constexpr T operator-=(T arg) noexcept requires std::integral<T> || std::floating_point<T> { return value_ -= arg; }
+  constexpr T operator&=(T arg) noexcept requires std::integral<T> { return value_ &= arg; }
+  constexpr T operator|=(T arg) noexcept requires std::integral<T> { return value_ |= arg; }
+  constexpr T operator^=(T arg) noexcept requires std::integral<T> { return value_ ^= arg; }
+
+private:
+  T value_{};
+};
+
 }  // namespace yk
 
 #endif  // __cpp_lib_parallel_algorithm >= 201603L
@@ -1,18 +1,32 @@
 #ifndef YK_PAR_FOR_EACH_HPP
 #define YK_PAR_FOR_EACH_HPP
 
-#include <version>
+#include "yk/exec/worker_pool.hpp"
 
-#if __cpp_lib_parallel_algorithm >= 201603L
+#include "yk/aggregate_exception.hpp"
+
+#include "yk/arch.hpp"
+
+#include <version>
 
 #include <algorithm>
+#include <atomic>
 #include <exception>
-#include <execution>
 #include <functional>
+#include <iterator>
+#include <latch>
+#include <memory>
 #include <ranges>
-#include <shared_mutex>
+#include <stop_token>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#include <cstddef>
+
+#if __cpp_lib_parallel_algorithm >= 201603L
+#include <execution>
+#endif
 
 namespace yk {
 
@@ -24,12 +38,39 @@ inline constexpr bool is_job_policy_v = is_job_policy<JobPolicy>::value;
 
 namespace execution {
 
+// stops taking new elements after the first exception, which is rethrown as-is
 struct abort_policy {};
-struct proceed_policy {};
+
+// processes every element, then throws an aggregate_exception holding
+// the first `max_exceptions` exceptions (the rest are only counted)
+struct proceed_policy {
+  static constexpr std::size_t default_max_exceptions = 64;
+
+  std::size_t max_exceptions = default_max_exceptions;
+};
 
 inline constexpr abort_policy abort{};
 inline constexpr proceed_policy proceed{};
 
+// Runs yk::for_each on the free workers of an exec::worker_pool, plus the calling thread.
+// The range is split into chunks (chunk_size == 0 picks 4 chunks per thread);
+// each thread takes its own share first, then steals the chunks left to the others.
+//
+// Only the workers launched by the call are waited for, so the pool may also run e.g. a scheduler,
+// and the call may be made from one of its workers.
+class worker_pool_policy {
+public:
+  explicit worker_pool_policy(std::shared_ptr<exec::worker_pool> pool, std::size_t chunk_size = 0) noexcept
+      : pool_(std::move(pool)), chunk_size_(chunk_size) {}
+
+  [[nodiscard]] exec::worker_pool& pool() const noexcept { return *pool_; }
+  [[nodiscard]] std::size_t chunk_size() const noexcept { return chunk_size_; }
+
+private:
+  std::shared_ptr<exec::worker_pool> pool_;
+  std::size_t chunk_size_;
+};
+
 }  // namespace execution
 
 template <>
@@ -38,27 +79,232 @@ struct is_job_policy<execution::abort_policy> : std::true_type {};
 template <>
 struct is_job_policy<execution::proceed_policy> : std::true_type {};
 
+#if __cpp_lib_parallel_algorithm >= 201603L
+template <class Policy>
+struct is_execution_policy : std::is_execution_policy<Policy> {};
+#else
+template <class Policy>
+struct is_execution_policy : std::false_type {};
+#endif
+
+template <>
+struct is_execution_policy<execution::worker_pool_policy> : std::true_type {};
+
+template <class Policy>
+inline constexpr bool is_execution_policy_v = is_execution_policy<Policy>::value;
+
+namespace detail {
+
+// Shared by every invocation of one algorithm call.
+// abort: only the first throwing invocation writes; the others just load `failed_`,
+//        which stays in every core's cache until then.
+// proceed: each throwing invocation claims its own slot with a single fetch_add;
+//          the slots are allocated once, so mass failure does not allocate.
+template <class JobPolicy>
+class job_state {
+public:
+  using job_policy_type = std::remove_cvref_t<JobPolicy>;
+  static constexpr bool is_abort = std::is_same_v<job_policy_type, execution::abort_policy>;
+
+  explicit job_state(const job_policy_type& job_policy) {
+    if constexpr (!is_abort) {
+      max_exceptions_ = job_policy.max_exceptions;
+      slots_ = std::make_unique<std::exception_ptr[]>(max_exceptions_);
+    }
+  }
+
+  job_state(const job_state&) = delete;
+  job_state& operator=(const job_state&) = delete;
+
+  // thread-safe
+  // returns false if f threw, or was skipped after an abort
+  template <class F>
+  bool run(F&& f) noexcept {
+    if (aborted()) return false;
+    try {
+      std::invoke(std::forward<F>(f));
+      return true;
+    } catch (...) {
+      if constexpr (is_abort) {
+        bool expected = false;
+        if (failed_.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+          exception_ = std::current_exception();
+        }
+      } else {
+        const auto i = failed_count_.fetch_add(1, std::memory_order_relaxed);
+        if (i < max_exceptions_) slots_[i] = std::current_exception();
+      }
+      return false;
+    }
+  }
+
+  [[nodiscard]] bool aborted() const noexcept {
+    if constexpr (is_abort) {
+      return failed_.load(std::memory_order_relaxed);
+    } else {
+      return false;
+    }
+  }
+
+  // call after every invocation has been joined
+  void rethrow_if_failed() const {
+    if constexpr (is_abort) {
+      if (exception_) std::rethrow_exception(exception_);
+    } else {
+      const auto failed_count = failed_count_.load(std::memory_order_relaxed);
+      if (failed_count == 0) return;
+      const auto retained = std::min(failed_count, max_exceptions_);
+      throw aggregate_exception(aggregate_exception::container_type(slots_.get(), slots_.get() + retained), failed_count - retained);
+    }
+  }
+
+private:
+  // abort
+  std::atomic<bool> failed_ = false;
+  std::exception_ptr exception_;
+
+  // proceed
+  std::atomic<std::size_t> failed_count_ = 0;
+  std::size_t max_exceptions_ = 0;
+  std::unique_ptr<std::exception_ptr[]> slots_;
+};
+
+// [first, last) split into chunks of `chunk_size` elements (the last one may be shorter)
+template <std::forward_iterator ForwardIterator>
+class chunked_range {
+public:
+  chunked_range(ForwardIterator first, ForwardIterator last, std::size_t size, std::size_t chunk_size)
+      : first_(first), size_(size), chunk_size_(chunk_size), chunk_count_((size + chunk_size - 1) / chunk_size) {
+    // random access iterators compute the bounds on the fly
+    if constexpr (!std::random_access_iterator<ForwardIterator>) {
+      bounds_.reserve(chunk_count_ + 1);
+      for (std::size_t i = 0; i < chunk_count_; ++i) {
+        bounds_.push_back(first);
+        std::ranges::advance(first, static_cast<std::iter_difference_t<ForwardIterator>>(chunk_size), last);
+      }
+      bounds_.push_back(last);
+    }
+  }
+
+  [[nodiscard]] std::size_t chunk_count() const noexcept { return chunk_count_; }
+
+  [[nodiscard]] ForwardIterator begin_of(std::size_t chunk) const {
+    if constexpr (std::random_access_iterator<ForwardIterator>) {
+      return first_ + static_cast<std::iter_difference_t<ForwardIterator>>(std::min(chunk * chunk_size_, size_));
+    } else {
+      return bounds_[chunk];
+    }
+  }
+
+  [[nodiscard]] ForwardIterator end_of(std::size_t chunk) const { return begin_of(chunk + 1); }
+
+private:
+  ForwardIterator first_;
+  std::size_t size_;
+  std::size_t chunk_size_;
+  std::size_t chunk_count_;
+  std::vector<ForwardIterator> bounds_;
+};
+
+// the calling thread plus the workers the pool can still launch
+[[nodiscard]] inline std::size_t pool_thread_count(const execution::worker_pool_policy& policy) noexcept {
+  const auto& pool = policy.pool();
+  return static_cast<std::size_t>(std::max(1, pool.get_worker_limit() - pool.launched_worker_count()));
+}
+
+[[nodiscard]] inline std::size_t pool_chunk_size(const execution::worker_pool_policy& policy, std::size_t size, std::size_t thread_count) noexcept {
+  return policy.chunk_size() != 0 ? policy.chunk_size() : std::max<std::size_t>(1, size / (thread_count * 4));
+}
+
+// Invokes f(thread, chunk) for every chunk in [0, chunk_count); thread is in [0, thread_count).
+// Thread i first takes its own contiguous share of chunks, then steals the ones left to the others.
+// f must not throw. Stops taking chunks once `aborted()` holds.
+template <class F, class Aborted>
+void pool_run_chunks(const execution::worker_pool_policy& policy, std::size_t thread_count, std::size_t chunk_count, const F& f,
+                     const Aborted& aborted) {
+  YK_FORCEALIGN_BEGIN
+  struct alignas(yk::hardware_destructive_interference_size) lane {
+    std::atomic<std::size_t> next = 0;
+    std::size_t end = 0;
+  };
+  YK_FORCEALIGN_END
+
+  // thread i owns chunks [lanes[i].next, lanes[i].end)
+  const auto lanes = std::make_unique<lane[]>(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    lanes[i].next.store(chunk_count * i / thread_count, std::memory_order_relaxed);
+    lanes[i].end = chunk_count * (i + 1) / thread_count;
+  }
+
+  const auto run = [&](std::size_t self) noexcept {
+    for (std::size_t k = 0; k < thread_count; ++k) {
+      auto& lane = lanes[(self + k) % thread_count];
+      while (true) {
+        if (aborted()) return;
+        const auto chunk = lane.next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= lane.end) break;
+        f(self, chunk);
+      }
+    }
+  };
+
+  // counted down by the workers launched here; the pool's other workers are never waited for
+  std::latch done(static_cast<std::ptrdiff_t>(thread_count - 1));
+
+  auto& pool = policy.pool();
+  std::vector<exec::thread_index_t> worker_ids;
+  worker_ids.reserve(thread_count - 1);
+  try {
+    for (std::size_t i = 1; i < thread_count; ++i) {
+      worker_ids.push_back(pool.launch([&run, &done, i](exec::thread_index_t, std::stop_token) {
+        run(i);
+        done.count_down();
+      }));
+    }
+  } catch (...) {
+    done.count_down(static_cast<std::ptrdiff_t>(thread_count - 1 - worker_ids.size()));
+    done.wait();
+    pool.join(worker_ids);
+    throw;
+  }
+  run(0);
+  done.wait();
+  // the workers have returned; joining them only frees their slots for the next call
+  pool.join(worker_ids);
+}
+
+}  // namespace detail
+
 template <class JobPolicy, class Policy, std::forward_iterator ForwardIterator, class Func>
-void for_each(JobPolicy&&, Policy&& policy, ForwardIterator first, ForwardIterator last, Func func) {
+void for_each(JobPolicy&& job_policy, Policy&& policy, ForwardIterator first, ForwardIterator last, Func func) {
   static_assert(is_job_policy_v<std::remove_cvref_t<JobPolicy>>);
-  static_assert(std::is_execution_policy_v<std::remove_cvref_t<Policy>>);
+  static_assert(is_execution_policy_v<std::remove_cvref_t<Policy>>);
   static_assert(std::is_copy_constructible_v<Func>, "std::for_each requires func to be CopyConstructible");
-  std::shared_mutex mtx;
-  std::exception_ptr exception;
+
+  detail::job_state<JobPolicy> state(job_policy);
   const auto wrapper = [&, func = std::move(func)]<class T>(T&& arg) noexcept {
-    try {
-      if constexpr (std::is_same_v<std::remove_cvref_t<JobPolicy>, execution::abort_policy>) {
-        std::shared_lock lock{mtx};
-        if (exception) return;
-      }
-      std::invoke(func, std::forward<T>(arg));
-    } catch (...) {
-      std::lock_guard lock{mtx};
-      exception = std::current_exception();
-    }
+    state.run([&] { std::invoke(func, std::forward<T>(arg)); });
   };
-  std::for_each(std::forward<Policy>(policy), first, last, wrapper);
-  if (exception) std::rethrow_exception(exception);
+
+  if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, execution::worker_pool_policy>) {
+    const auto size = static_cast<std::size_t>(std::ranges::distance(first, last));
+    if (size != 0) {
+      const auto thread_count = detail::pool_thread_count(policy);
+      const detail::chunked_range chunks(first, last, size, detail::pool_chunk_size(policy, size, thread_count));
+      detail::pool_run_chunks(
+          policy, thread_count, chunks.chunk_count(),
+          [&](std::size_t, std::size_t chunk) noexcept {
+            for (auto it = chunks.begin_of(chunk), it_end = chunks.end_of(chunk); it != it_end; ++it) wrapper(*it);
+          },
+          [&] { return state.aborted(); });
+    }
+  } else {
+#if __cpp_lib_parallel_algorithm >= 201603L
+    std::for_each(std::forward<Policy>(policy), first, last, wrapper);
+#endif
+  }
+  // every invocation has been joined, so the exception is visible here
+  state.rethrow_if_failed();
 }
 
 template <class Policy, std::forward_iterator ForwardIterator, class Func>
@@ -66,6 +312,19 @@ void for_each(Policy&& policy, ForwardIterator first, ForwardIterator last, Func
   for_each(execution::abort, std::forward<Policy>(policy), first, last, std::move(func));
 }
 
+template <class JobPolicy, class Policy, std::forward_iterator ForwardIterator, std::integral Size, class Func>
+ForwardIterator for_each_n(JobPolicy&& job_policy, Policy&& policy, ForwardIterator first, Size n, Func func) {
+  if (n <= 0) return first;
+  const auto last = std::ranges::next(first, static_cast<std::iter_difference_t<ForwardIterator>>(n));
+  for_each(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), first, last, std::move(func));
+  return last;
+}
+
+template <class Policy, std::forward_iterator ForwardIterator, std::integral Size, class Func>
+ForwardIterator for_each_n(Policy&& policy, ForwardIterator first, Size n, Func func) {
+  return for_each_n(execution::abort, std::forward<Policy>(policy), first, n, std::move(func));
+}
+
 namespace ranges {
 
 template <class JobPolicy, class Policy, std::ranges::forward_range R, class Func>
@@ -90,10 +349,18 @@ void for_each(Policy&& policy, I iter, S sent, Func func) {
   for_each(execution::abort, std::forward<Policy>(policy), iter, sent, std::move(func));
 }
 
+template <class JobPolicy, class Policy, std::forward_iterator I, class Func>
+I for_each_n(JobPolicy&& job_policy, Policy&& policy, I first, std::iter_difference_t<I> n, Func func) {
+  return ::yk::for_each_n(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), first, n, std::move(func));
+}
+
+template <class Policy, std::forward_iterator I, class Func>
+I for_each_n(Policy&& policy, I first, std::iter_difference_t<I> n, Func func) {
+  return for_each_n(execution::abort, std::forward<Policy>(policy), first, n, std::move(func));
+}
+
 }  // namespace ranges
 
 }  // namespace yk
 
-#endif  // __cpp_lib_parallel_algorithm
-
 #endif  // YK_PAR_FOR_EACH_HPP
@@ -0,0 +1,181 @@
+#ifndef YK_PAR_REDUCE_HPP
+#define YK_PAR_REDUCE_HPP
+
+#include "yk/par_for_each.hpp"
+
+#include "yk/arch.hpp"
+
+#include <version>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+#if __cpp_lib_parallel_algorithm >= 201603L
+#include <execution>
+#endif
+
+namespace yk {
+
+namespace detail {
+
+YK_FORCEALIGN_BEGIN
+// one per worker (or per chunk), so that no two accumulators share a cache line
+template <class T>
+struct alignas(yk::hardware_destructive_interference_size) padded_accumulator {
+  std::optional<T> value;
+};
+YK_FORCEALIGN_END
+
+template <class T, class BinaryOp>
+void accumulate_into(std::optional<T>& acc, BinaryOp& reduce_op, T&& value) {
+  if (acc) {
+    *acc = std::invoke(reduce_op, std::move(*acc), std::move(value));
+  } else {
+    acc.emplace(std::move(value));
+  }
+}
+
+// pairwise combine: (0 1) (2 3) ..., then (0 2) (4 6) ..., so the depth is log2(n)
+template <class T, class BinaryOp>
+T tree_combine(std::unique_ptr<padded_accumulator<T>[]>& accs, std::size_t n, T init, BinaryOp& reduce_op) {
+  for (std::size_t step = 1; step < n; step *= 2) {
+    for (std::size_t i = 0; i + step < n; i += 2 * step) {
+      if (auto& rhs = accs[i + step].value) accumulate_into(accs[i].value, reduce_op, std::move(*rhs));
+    }
+  }
+  if (n == 0 || !accs[0].value) return init;
+  return std::invoke(reduce_op, std::move(init), std::move(*accs[0].value));
+}
+
+template <class JobPolicy, class Policy, std::forward_iterator ForwardIterator, class T, class BinaryOp, class UnaryOp>
+T transform_reduce_impl(const JobPolicy& job_policy, Policy&& policy, ForwardIterator first, ForwardIterator last, T init, BinaryOp reduce_op, UnaryOp transform_op) {
+  static_assert(is_job_policy_v<JobPolicy>);
+  static_assert(is_execution_policy_v<std::remove_cvref_t<Policy>>);
+
+  const auto size = static_cast<std::size_t>(std::ranges::distance(first, last));
+  if (size == 0) return init;
+
+  job_state<JobPolicy> state(job_policy);
+  std::unique_ptr<padded_accumulator<T>[]> accs;
+  std::size_t acc_count = 0;
+
+  const auto reduce_chunk = [&](std::optional<T>& acc, ForwardIterator it, ForwardIterator it_end) noexcept {
+    for (; it != it_end; ++it) {
+      // a throwing element is left out of the sum
+      state.run([&] { accumulate_into(acc, reduce_op, static_cast<T>(std::invoke(transform_op, *it))); });
+    }
+  };
+
+  if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, execution::worker_pool_policy>) {
+    // one accumulator per thread
+    const auto thread_count = pool_thread_count(policy);
+    const chunked_range chunks(first, last, size, pool_chunk_size(policy, size, thread_count));
+    acc_count = thread_count;
+    accs = std::make_unique<padded_accumulator<T>[]>(acc_count);
+    pool_run_chunks(
+        policy, thread_count, chunks.chunk_count(),
+        [&](std::size_t self, std::size_t chunk) noexcept { reduce_chunk(accs[self].value, chunks.begin_of(chunk), chunks.end_of(chunk)); },
+        [&] { return state.aborted(); });
+  } else {
+#if __cpp_lib_parallel_algorithm >= 201603L
+    // one accumulator per chunk; the standard algorithm does not tell us the worker
+    const auto chunk_target = std::max<std::size_t>(1, std::thread::hardware_concurrency()) * 4;
+    const chunked_range chunks(first, last, size, std::max<std::size_t>(1, (size + chunk_target - 1) / chunk_target));
+    acc_count = chunks.chunk_count();
+    accs = std::make_unique<padded_accumulator<T>[]>(acc_count);
+    std::vector<std::size_t> chunk_ids(acc_count);
+    std::iota(chunk_ids.begin(), chunk_ids.end(), std::size_t{0});
+    std::for_each(std::forward<Policy>(policy), chunk_ids.begin(), chunk_ids.end(), [&](std::size_t chunk) noexcept {
+      if (state.aborted()) return;
+      reduce_chunk(accs[chunk].value, chunks.begin_of(chunk), chunks.end_of(chunk));
+    });
+#endif
+  }
+
+  state.rethrow_if_failed();
+  return tree_combine(accs, acc_count, std::move(init), reduce_op);
+}
+
+template <class JobPolicy, class Policy>
+concept job_and_execution_policy =
+    is_job_policy_v<std::remove_cvref_t<JobPolicy>> && is_execution_policy_v<std::remove_cvref_t<Policy>>;
+
+template <class Policy>
+concept plain_execution_policy = !is_job_policy_v<std::remove_cvref_t<Policy>> && is_execution_policy_v<std::remove_cvref_t<Policy>>;
+
+}  // namespace detail
+
+// reduce_op must be associative and commutative; values are combined in an unspecified order.
+
+template <class JobPolicy, class Policy, std::forward_iterator ForwardIterator, class T, class BinaryOp, class UnaryOp>
+  requires detail::job_and_execution_policy<JobPolicy, Policy>
+T transform_reduce(JobPolicy&& job_policy, Policy&& policy, ForwardIterator first, ForwardIterator last, T init, BinaryOp reduce_op,
+                   UnaryOp transform_op) {
+  return detail::transform_reduce_impl(std::as_const(job_policy), std::forward<Policy>(policy), first, last, std::move(init), std::move(reduce_op),
+                                       std::move(transform_op));
+}
+
+template <class Policy, std::forward_iterator ForwardIterator, class T, class BinaryOp, class UnaryOp>
+  requires detail::plain_execution_policy<Policy>
+T transform_reduce(Policy&& policy, ForwardIterator first, ForwardIterator last, T init, BinaryOp reduce_op, UnaryOp transform_op) {
+  return ::yk::transform_reduce(execution::abort, std::forward<Policy>(policy), first, last, std::move(init), std::move(reduce_op), std::move(transform_op));
+}
+
+template <class JobPolicy, class Policy, std::forward_iterator ForwardIterator, class T, class BinaryOp = std::plus<>>
+  requires detail::job_and_execution_policy<JobPolicy, Policy>
+T reduce(JobPolicy&& job_policy, Policy&& policy, ForwardIterator first, ForwardIterator last, T init, BinaryOp reduce_op = {}) {
+  return ::yk::transform_reduce(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), first, last, std::move(init), std::move(reduce_op),
+                                std::identity{});
+}
+
+template <class Policy, std::forward_iterator ForwardIterator, class T, class BinaryOp = std::plus<>>
+  requires detail::plain_execution_policy<Policy>
+T reduce(Policy&& policy, ForwardIterator first, ForwardIterator last, T init, BinaryOp reduce_op = {}) {
+  return ::yk::reduce(execution::abort, std::forward<Policy>(policy), first, last, std::move(init), std::move(reduce_op));
+}
+
+namespace ranges {
+
+template <class JobPolicy, class Policy, std::ranges::forward_range R, class T, class BinaryOp, class UnaryOp>
+  requires detail::job_and_execution_policy<JobPolicy, Policy> && std::ranges::common_range<R>
+T transform_reduce(JobPolicy&& job_policy, Policy&& policy, R&& r, T init, BinaryOp reduce_op, UnaryOp transform_op) {
+  return ::yk::transform_reduce(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), std::ranges::begin(r), std::ranges::end(r),
+                                std::move(init), std::move(reduce_op), std::move(transform_op));
+}
+
+template <class Policy, std::ranges::forward_range R, class T, class BinaryOp, class UnaryOp>
+  requires detail::plain_execution_policy<Policy> && std::ranges::common_range<R>
+T transform_reduce(Policy&& policy, R&& r, T init, BinaryOp reduce_op, UnaryOp transform_op) {
+  return ::yk::ranges::transform_reduce(execution::abort, std::forward<Policy>(policy), std::forward<R>(r), std::move(init), std::move(reduce_op),
+                                        std::move(transform_op));
+}
+
+template <class JobPolicy, class Policy, std::ranges::forward_range R, class T, class BinaryOp = std::plus<>>
+  requires detail::job_and_execution_policy<JobPolicy, Policy> && std::ranges::common_range<R>
+T reduce(JobPolicy&& job_policy, Policy&& policy, R&& r, T init, BinaryOp reduce_op = {}) {
+  return ::yk::reduce(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), std::ranges::begin(r), std::ranges::end(r), std::move(init),
+                      std::move(reduce_op));
+}
+
+template <class Policy, std::ranges::forward_range R, class T, class BinaryOp = std::plus<>>
+  requires detail::plain_execution_policy<Policy> && std::ranges::common_range<R>
+T reduce(Policy&& policy, R&& r, T init, BinaryOp reduce_op = {}) {
+  return ::yk::ranges::reduce(execution::abort, std::forward<Policy>(policy), std::forward<R>(r), std::move(init), std::move(reduce_op));
+}
+
+}  // namespace ranges
+
+}  // namespace yk
+
+#endif  // YK_PAR_REDUCE_HPP
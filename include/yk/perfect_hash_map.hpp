@@ -0,0 +1,226 @@
+#ifndef YK_PERFECT_HASH_MAP_HPP
+#define YK_PERFECT_HASH_MAP_HPP
+
+#include "yk/fixed_string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+// Minimal perfect hash map over a fixed set of string keys, built at compile time
+// (PTHash-style: keys are split into buckets by their hash, and each bucket gets a
+// "pilot" that scatters its keys onto free slots of a table of exactly N entries).
+// A lookup is one hash of the key, one pilot load and one key compare.
+
+namespace yk {
+
+namespace detail::perfect_hash {
+
+// murmur3 fmix64
+[[nodiscard]] constexpr std::uint64_t fmix(std::uint64_t x) noexcept {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+// FNV-1a over the code units, finalized with fmix; usable in constant evaluation
+template <class CharT, class Traits>
+[[nodiscard]] constexpr std::uint64_t hash(std::basic_string_view<CharT, Traits> str, std::uint64_t seed) noexcept {
+  std::uint64_t h = 14695981039346656037ull ^ seed;
+  for (const CharT c : str) {
+    h = (h ^ static_cast<std::make_unsigned_t<CharT>>(c)) * 1099511628211ull;
+  }
+  return fmix(h);
+}
+
+[[nodiscard]] constexpr std::size_t bucket_count(std::size_t n) noexcept { return n / 2 + 1; }
+
+[[nodiscard]] constexpr std::size_t bucket_of(std::uint64_t h, std::size_t buckets) noexcept {
+  return static_cast<std::size_t>(((h >> 32) * buckets) >> 32);
+}
+
+[[nodiscard]] constexpr std::size_t slot_of(std::uint64_t h, std::uint64_t pilot, std::size_t n) noexcept {
+  return static_cast<std::size_t>(fmix(h ^ pilot) % n);
+}
+
+inline constexpr std::uint64_t max_seed_attempts = 64;
+inline constexpr std::uint64_t max_pilot_attempts = 1 << 16;
+
+template <std::size_t N>
+struct layout {
+  std::uint64_t seed = 0;
+  std::array<std::uint64_t, bucket_count(N)> pilots{};
+  std::array<std::size_t, N> order{};  // order[slot] = index of the input entry stored there
+};
+
+template <std::size_t N, class CharT, class Traits>
+[[nodiscard]] constexpr bool try_build(const std::array<std::basic_string_view<CharT, Traits>, N>& keys, layout<N>& out) {
+  constexpr std::size_t buckets = bucket_count(N);
+
+  std::array<std::uint64_t, N> hashes{};
+  for (std::size_t i = 0; i < N; ++i) {
+    hashes[i] = hash(keys[i], out.seed);
+    for (std::size_t j = 0; j < i; ++j) {
+      if (hashes[i] == hashes[j]) return false;
+    }
+  }
+
+  std::array<std::size_t, N> by_bucket{};
+  std::array<std::size_t, buckets + 1> bucket_begin{};
+  for (std::size_t i = 0; i < N; ++i) ++bucket_begin[bucket_of(hashes[i], buckets) + 1];
+  for (std::size_t b = 0; b < buckets; ++b) bucket_begin[b + 1] += bucket_begin[b];
+  {
+    auto fill = bucket_begin;
+    for (std::size_t i = 0; i < N; ++i) by_bucket[fill[bucket_of(hashes[i], buckets)]++] = i;
+  }
+
+  // place the largest buckets first, while the table is still empty
+  std::array<std::size_t, buckets> bucket_order{};
+  for (std::size_t b = 0; b < buckets; ++b) bucket_order[b] = b;
+  std::ranges::sort(bucket_order, [&](std::size_t a, std::size_t b) {
+    const std::size_t size_a = bucket_begin[a + 1] - bucket_begin[a], size_b = bucket_begin[b + 1] - bucket_begin[b];
+    return size_a != size_b ? size_a > size_b : a < b;
+  });
+
+  std::array<bool, N> taken{};
+  for (const std::size_t b : bucket_order) {
+    const std::size_t first = bucket_begin[b], last = bucket_begin[b + 1];
+    if (first == last) break;
+
+    bool placed = false;
+    for (std::uint64_t attempt = 0; attempt < max_pilot_attempts && !placed; ++attempt) {
+      const std::uint64_t pilot = fmix(attempt + 0x9e3779b97f4a7c15ull);
+      placed = true;
+      for (std::size_t k = first; k < last && placed; ++k) {
+        const std::size_t slot = slot_of(hashes[by_bucket[k]], pilot, N);
+        if (taken[slot]) placed = false;
+        for (std::size_t l = first; l < k && placed; ++l) {
+          if (slot_of(hashes[by_bucket[l]], pilot, N) == slot) placed = false;
+        }
+      }
+      if (placed) {
+        out.pilots[b] = pilot;
+        for (std::size_t k = first; k < last; ++k) {
+          const std::size_t slot = slot_of(hashes[by_bucket[k]], pilot, N);
+          taken[slot] = true;
+          out.order[slot] = by_bucket[k];
+        }
+      }
+    }
+    if (!placed) return false;
+  }
+  return true;
+}
+
+template <std::size_t N, class CharT, class Traits>
+[[nodiscard]] constexpr layout<N> build(const std::array<std::basic_string_view<CharT, Traits>, N>& keys) {
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < i; ++j) {
+      if (keys[i] == keys[j]) throw std::invalid_argument("duplicate key in perfect hash map");
+    }
+  }
+  layout<N> out;
+  for (; out.seed < max_seed_attempts; ++out.seed) {
+    if (try_build(keys, out)) return out;
+    out.pilots = {};
+  }
+  throw std::invalid_argument("failed to build perfect hash map");
+}
+
+}  // namespace detail::perfect_hash
+
+// The keys are views; they must outlive the map (string literals, or template
+// parameter objects as in perfect_hash_index). Construct it in a constant
+// expression so that an invalid key set is a compile error.
+template <class T, std::size_t N, class CharT = char, class Traits = std::char_traits<CharT>>
+class basic_perfect_hash_map {
+public:
+  using key_type = std::basic_string_view<CharT, Traits>;
+  using mapped_type = T;
+  using value_type = std::pair<key_type, T>;
+  using size_type = std::size_t;
+  using const_iterator = typename std::array<value_type, N>::const_iterator;
+
+  constexpr explicit basic_perfect_hash_map(const std::array<value_type, N>& entries)
+      : basic_perfect_hash_map(entries, detail::perfect_hash::build(keys_of(entries)), std::make_index_sequence<N>{}) {}
+
+  [[nodiscard]] constexpr const_iterator begin() const noexcept { return entries_.begin(); }
+  [[nodiscard]] constexpr const_iterator end() const noexcept { return entries_.end(); }
+
+  [[nodiscard]] static constexpr size_type size() noexcept { return N; }
+  [[nodiscard]] static constexpr bool empty() noexcept { return N == 0; }
+
+  [[nodiscard]] constexpr const_iterator find(key_type key) const noexcept {
+    if constexpr (N == 0) {
+      return end();
+    } else {
+      namespace ph = detail::perfect_hash;
+      const std::uint64_t h = ph::hash(key, seed_);
+      const std::size_t slot = ph::slot_of(h, pilots_[ph::bucket_of(h, pilots_.size())], N);
+      return entries_[slot].first == key ? begin() + slot : end();
+    }
+  }
+
+  [[nodiscard]] constexpr bool contains(key_type key) const noexcept { return find(key) != end(); }
+
+  [[nodiscard]] constexpr const T& at(key_type key) const {
+    const auto it = find(key);
+    if (it == end()) throw std::out_of_range("key not found in perfect hash map");
+    return it->second;
+  }
+
+private:
+  template <std::size_t... Is>
+  constexpr basic_perfect_hash_map(const std::array<value_type, N>& entries, const detail::perfect_hash::layout<N>& layout, std::index_sequence<Is...>)
+      : seed_(layout.seed), pilots_(layout.pilots), entries_{entries[layout.order[Is]]...} {}
+
+  [[nodiscard]] static constexpr std::array<key_type, N> keys_of(const std::array<value_type, N>& entries) {
+    std::array<key_type, N> keys;
+    for (std::size_t i = 0; i < N; ++i) keys[i] = entries[i].first;
+    return keys;
+  }
+
+  std::uint64_t seed_;
+  std::array<std::uint64_t, detail::perfect_hash::bucket_count(N)> pilots_;
+  std::array<value_type, N> entries_;
+};
+
+template <class T, std::size_t N>
+using perfect_hash_map = basic_perfect_hash_map<T, N, char>;
+
+template <class CharT, class Traits, class T, std::size_t N>
+[[nodiscard]] constexpr basic_perfect_hash_map<T, N, CharT, Traits> make_perfect_hash_map(const std::array<std::pair<std::basic_string_view<CharT, Traits>, T>, N>& entries) {
+  return basic_perfect_hash_map<T, N, CharT, Traits>(entries);
+}
+
+namespace detail {
+
+template <basic_fixed_string First, basic_fixed_string... Rest, std::size_t... Is>
+[[nodiscard]] consteval auto make_perfect_hash_index(std::index_sequence<Is...>) {
+  using key_type = typename decltype(First)::string_view_type;
+  static_assert((std::is_same_v<typename decltype(Rest)::string_view_type, key_type> && ...), "all keys must have the same character type");
+  return basic_perfect_hash_map<std::size_t, 1 + sizeof...(Is), typename key_type::value_type, typename key_type::traits_type>(
+      std::array{std::pair{static_cast<key_type>(First), std::size_t{0}}, std::pair{static_cast<key_type>(Rest), Is + 1}...}
+  );
+}
+
+}  // namespace detail
+
+// Maps each of the fixed_string keys to its position in the list.
+//   yk::perfect_hash_index<"foo", "bar">.find("bar")->second == 1
+template <basic_fixed_string First, basic_fixed_string... Rest>
+inline constexpr auto perfect_hash_index = detail::make_perfect_hash_index<First, Rest...>(std::index_sequence_for<decltype(Rest)...>{});
+
+}  // namespace yk
+
+#endif  // YK_PERFECT_HASH_MAP_HPP
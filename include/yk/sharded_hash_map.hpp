@@ -0,0 +1,371 @@
+#ifndef YK_SHARDED_HASH_MAP_HPP
+#define YK_SHARDED_HASH_MAP_HPP
+
+#include "yk/arch.hpp"
+#include "yk/flat_hash_map.hpp"
+#include "yk/hash/hash_value_for.hpp"
+#include "yk/par_for_each.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yk {
+
+namespace detail {
+
+// exposes the prehashed operations of the table to sharded_hash_map
+template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+class sharded_hash_map_shard : public flat_hash_map<Key, T, Hash, KeyEqual, Allocator> {
+  using base_type = flat_hash_map<Key, T, Hash, KeyEqual, Allocator>;
+
+public:
+  using base_type::base_type;
+  using base_type::operator=;
+
+  sharded_hash_map_shard() = default;
+
+  using base_type::emplace_unique_hashed;
+  using base_type::erase_hashed;
+  using base_type::find_hashed;
+  using base_type::hash_of;
+};
+
+}  // namespace detail
+
+// Concurrent hash map: a power-of-two number of flat_hash_map shards, each behind
+// its own shared mutex on its own cache line. The shard is chosen by the high bits
+// of the (mixed) hash, which is computed before taking the lock; the shard's table
+// uses the low bits, so the two choices are independent.
+//
+// There are no iterators; elements are accessed under the shard's lock through
+// visit / cvisit, or a whole shard at a time through for_each_shard.
+//
+// For write-heavy phases, each thread can stage its insertions in an insert_buffer,
+// which takes every shard's lock once per batch instead of once per element.
+template <class Key, class T, class Hash = hash_value_for_fn, class KeyEqual = std::equal_to<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T>>, class SharedMutex = std::shared_mutex>
+class sharded_hash_map {
+  using shard_map_type = detail::sharded_hash_map_shard<Key, T, Hash, KeyEqual, Allocator>;
+
+  YK_FORCEALIGN_BEGIN
+  struct alignas(yk::hardware_destructive_interference_size) shard {
+    mutable SharedMutex mtx;
+    shard_map_type map;
+  };
+  YK_FORCEALIGN_END
+
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  using shard_type = flat_hash_map<Key, T, Hash, KeyEqual, Allocator>;
+
+  class insert_buffer;
+
+  // 4 shards per hardware thread, rounded up to a power of two
+  [[nodiscard]] static size_type default_shard_count() noexcept {
+    return std::bit_ceil(std::clamp<size_type>(std::thread::hardware_concurrency() * size_type{4}, 1, 1024));
+  }
+
+  sharded_hash_map() : sharded_hash_map(default_shard_count()) {}
+
+  // shard_count is rounded up to a power of two
+  explicit sharded_hash_map(size_type shard_count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+      : shard_bits_(static_cast<unsigned>(std::countr_zero(std::bit_ceil(std::max<size_type>(shard_count, 1))))),
+        shard_count_(size_type{1} << shard_bits_),
+        shards_(std::make_unique<shard[]>(shard_count_)) {
+    for (auto& s : shards()) s.map = shard_map_type(0, hash, equal, alloc);
+  }
+
+  sharded_hash_map(const sharded_hash_map&) = delete;
+  sharded_hash_map& operator=(const sharded_hash_map&) = delete;
+
+  [[nodiscard]] size_type shard_count() const noexcept { return shard_count_; }
+
+  // thread-safe; returns true if inserted
+  template <class... Args>
+  bool try_emplace(const key_type& key, Args&&... args) {
+    const auto h = hash_of(key);
+    auto& s = shard_for(h);
+    std::lock_guard lock{s.mtx};
+    return s.map.emplace_unique_hashed(h, key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)).second;
+  }
+
+  // thread-safe; returns true if inserted
+  template <class... Args>
+  bool emplace(Args&&... args) {
+    std::pair<Key, T> tmp(std::forward<Args>(args)...);
+    const auto h = hash_of(tmp.first);
+    auto& s = shard_for(h);
+    std::lock_guard lock{s.mtx};
+    return s.map.emplace_unique_hashed(h, tmp.first, std::move(tmp)).second;
+  }
+
+  // thread-safe; returns true if inserted
+  bool insert(const value_type& value) { return try_emplace(value.first, value.second); }
+  bool insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+  // thread-safe; returns true if inserted, false if assigned
+  template <class M>
+  bool insert_or_assign(const key_type& key, M&& obj) {
+    const auto h = hash_of(key);
+    auto& s = shard_for(h);
+    std::lock_guard lock{s.mtx};
+    auto [it, inserted] = s.map.emplace_unique_hashed(h, key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<M>(obj)));
+    if (!inserted) it->second = std::forward<M>(obj);
+    return inserted;
+  }
+
+  // thread-safe; inserts value_type(key, args...), or calls f(value_type&) on the existing element
+  // under the lock (e.g. to accumulate). Returns true if inserted.
+  template <class F, class... Args>
+  bool try_emplace_or_visit(const key_type& key, F&& f, Args&&... args) {
+    const auto h = hash_of(key);
+    auto& s = shard_for(h);
+    std::lock_guard lock{s.mtx};
+    auto [it, inserted] = s.map.emplace_unique_hashed(h, key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    if (!inserted) std::invoke(f, *it);
+    return inserted;
+  }
+
+  // thread-safe; calls f(value_type&) under the exclusive lock. Returns true if found.
+  template <class F>
+  bool visit(const key_type& key, F&& f) {
+    const auto h = hash_of(key);
+    auto& s = shard_for(h);
+    std::lock_guard lock{s.mtx};
+    const auto it = s.map.find_hashed(key, h);
+    if (it == s.map.end()) return false;
+    std::invoke(f, *it);
+    return true;
+  }
+
+  // thread-safe; calls f(const value_type&) under the shared lock. Returns true if found.
+  template <class F>
+  bool cvisit(const key_type& key, F&& f) const {
+    const auto h = hash_of(key);
+    const shard& s = shard_for(h);
+    std::shared_lock lock{s.mtx};
+    const auto it = s.map.find_hashed(key, h);
+    if (it == s.map.end()) return false;
+    std::invoke(f, *it);
+    return true;
+  }
+
+  // thread-safe; a copy of the mapped value
+  [[nodiscard]] std::optional<T> get(const key_type& key) const {
+    std::optional<T> result;
+    cvisit(key, [&](const value_type& value) { result.emplace(value.second); });
+    return result;
+  }
+
+  // thread-safe
+  [[nodiscard]] bool contains(const key_type& key) const {
+    return cvisit(key, [](const value_type&) noexcept {});
+  }
+
+  // thread-safe
+  [[nodiscard]] size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  // thread-safe
+  size_type erase(const key_type& key) {
+    const auto h = hash_of(key);
+    auto& s = shard_for(h);
+    std::lock_guard lock{s.mtx};
+    return s.map.erase_hashed(key, h);
+  }
+
+  // thread-safe; a snapshot that may be stale while other threads are modifying the map
+  [[nodiscard]] size_type size() const {
+    size_type n = 0;
+    for (const auto& s : shards()) {
+      std::shared_lock lock{s.mtx};
+      n += s.map.size();
+    }
+    return n;
+  }
+
+  // thread-safe; see size()
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  // thread-safe; each shard is cleared under its lock, not all at once
+  void clear() {
+    for (auto& s : shards()) {
+      std::lock_guard lock{s.mtx};
+      s.map.clear();
+    }
+  }
+
+  // thread-safe; room for `count` elements spread evenly over the shards
+  void reserve(size_type count) {
+    const size_type per_shard = (count + shard_count_ - 1) / shard_count_;
+    for (auto& s : shards()) {
+      std::lock_guard lock{s.mtx};
+      s.map.reserve(per_shard);
+    }
+  }
+
+  // thread-safe; f(shard_type&) for each shard under its exclusive lock, run through yk::for_each
+  template <class JobPolicy, class Policy, class F>
+  void for_each_shard(JobPolicy&& job_policy, Policy&& policy, F f) {
+    ::yk::ranges::for_each(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), shards(), [&f](shard& s) {
+      std::lock_guard lock{s.mtx};
+      std::invoke(f, static_cast<shard_type&>(s.map));
+    });
+  }
+
+  template <class Policy, class F>
+  void for_each_shard(Policy&& policy, F f) {
+    for_each_shard(execution::abort, std::forward<Policy>(policy), std::move(f));
+  }
+
+  // thread-safe; sequential
+  template <class F>
+  void for_each_shard(F f) {
+    for (auto& s : shards()) {
+      std::lock_guard lock{s.mtx};
+      std::invoke(f, static_cast<shard_type&>(s.map));
+    }
+  }
+
+  // thread-safe; f(const shard_type&) for each shard under its shared lock, run through yk::for_each
+  template <class JobPolicy, class Policy, class F>
+  void cfor_each_shard(JobPolicy&& job_policy, Policy&& policy, F f) const {
+    ::yk::ranges::for_each(std::forward<JobPolicy>(job_policy), std::forward<Policy>(policy), shards(), [&f](const shard& s) {
+      std::shared_lock lock{s.mtx};
+      std::invoke(f, static_cast<const shard_type&>(s.map));
+    });
+  }
+
+  template <class Policy, class F>
+  void cfor_each_shard(Policy&& policy, F f) const {
+    cfor_each_shard(execution::abort, std::forward<Policy>(policy), std::move(f));
+  }
+
+  // thread-safe; sequential
+  template <class F>
+  void cfor_each_shard(F f) const {
+    for (const auto& s : shards()) {
+      std::shared_lock lock{s.mtx};
+      std::invoke(f, static_cast<const shard_type&>(s.map));
+    }
+  }
+
+private:
+  template <class K>
+  [[nodiscard]] std::uint64_t hash_of(const K& key) const noexcept {
+    // every shard has the same hasher
+    return shards_[0].map.hash_of(key);
+  }
+
+  [[nodiscard]] size_type shard_index(std::uint64_t h) const noexcept {
+    // h >> (64 - shard_bits_), without the shift by 64 when there is only one shard
+    return static_cast<size_type>((h >> 1) >> (63 - shard_bits_));
+  }
+
+  [[nodiscard]] shard& shard_for(std::uint64_t h) const noexcept { return shards_[shard_index(h)]; }
+
+  [[nodiscard]] std::span<shard> shards() noexcept { return {shards_.get(), shard_count_}; }
+  [[nodiscard]] std::span<const shard> shards() const noexcept { return {shards_.get(), shard_count_}; }
+
+  unsigned shard_bits_;
+  size_type shard_count_;
+  std::unique_ptr<shard[]> shards_;
+};
+
+// Stages insertions per shard without any synchronization; a shard's batch is
+// inserted under a single lock once it reaches batch_size, and everything left is
+// inserted by flush() or the destructor. Staged elements are invisible to the map
+// until then. Like try_emplace, an element whose key is already present is dropped.
+//
+// Not thread-safe: one buffer per thread.
+template <class Key, class T, class Hash, class KeyEqual, class Allocator, class SharedMutex>
+class sharded_hash_map<Key, T, Hash, KeyEqual, Allocator, SharedMutex>::insert_buffer {
+public:
+  static constexpr size_type default_batch_size = 64;
+
+  explicit insert_buffer(sharded_hash_map& map, size_type batch_size = default_batch_size)
+      : map_(&map), batch_size_(std::max<size_type>(batch_size, 1)), pending_(map.shard_count()) {}
+
+  insert_buffer(const insert_buffer&) = delete;
+  insert_buffer& operator=(const insert_buffer&) = delete;
+
+  // call flush() beforehand to handle its exceptions
+  ~insert_buffer() { flush(); }
+
+  // not thread-safe
+  template <class... Args>
+  void try_emplace(const key_type& key, Args&&... args) {
+    stage(std::pair<Key, T>(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)));
+  }
+
+  // not thread-safe
+  template <class... Args>
+  void emplace(Args&&... args) {
+    stage(std::pair<Key, T>(std::forward<Args>(args)...));
+  }
+
+  // not thread-safe
+  void insert(const value_type& value) { try_emplace(value.first, value.second); }
+  void insert(value_type&& value) { try_emplace(value.first, std::move(value.second)); }
+
+  // not thread-safe (the map is thread-safe); staged elements become visible
+  void flush() {
+    for (size_type i = 0; i < pending_.size(); ++i) flush_shard(i);
+  }
+
+private:
+  void stage(std::pair<Key, T>&& value) {
+    const auto h = map_->hash_of(value.first);
+    const auto i = map_->shard_index(h);
+    auto& batch = pending_[i];
+    if (batch.capacity() == 0) batch.reserve(batch_size_);
+    batch.emplace_back(h, std::move(value));
+    if (batch.size() >= batch_size_) flush_shard(i);
+  }
+
+  void flush_shard(size_type i) {
+    auto& batch = pending_[i];
+    if (batch.empty()) return;
+    auto& s = map_->shards_[i];
+    std::size_t done = 0;
+    try {
+      std::lock_guard lock{s.mtx};
+      for (; done < batch.size(); ++done) {
+        auto& [h, value] = batch[done];
+        s.map.emplace_unique_hashed(h, value.first, std::move(value));
+      }
+    } catch (...) {
+      // keep the ones not inserted yet
+      batch.erase(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(done));
+      throw;
+    }
+    batch.clear();
+  }
+
+  sharded_hash_map* map_;
+  size_type batch_size_;
+  std::vector<std::vector<std::pair<std::uint64_t, std::pair<Key, T>>>> pending_;
+};
+
+}  // namespace yk
+
+#endif  // YK_SHARDED_HASH_MAP_HPP
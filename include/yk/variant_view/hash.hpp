@@ -3,6 +3,8 @@
 
 #include "yk/variant_view.hpp"
 
+#include "yk/variant_view/hash/hash_append.hpp"
+
 #if YK_VARIANT_INCLUDE_STD
 #include "yk/variant_view/hash/std_hash.hpp"
 #endif
@@ -0,0 +1,20 @@
+#ifndef YK_VARIANT_VIEW_HASH_APPEND_HPP
+#define YK_VARIANT_VIEW_HASH_APPEND_HPP
+
+#include "yk/variant_view.hpp"
+
+namespace yk {
+
+// defined in yk/hash/hash_append.hpp
+template <class HashAlgorithm, class T>
+void hash_append(HashAlgorithm& h, const T& x) noexcept;
+
+// same value as the viewed variant, like std::hash / hash_value
+template <class HashAlgorithm, class Variant, class... Ts>
+void hash_append(HashAlgorithm& h, const yk::variant_view<Variant, Ts...>& view) noexcept {
+  hash_append(h, view.base());
+}
+
+}  // namespace yk
+
+#endif  // YK_VARIANT_VIEW_HASH_APPEND_HPP
@@ -6,8 +6,15 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
 #include <tuple>
+#include <vector>
 #include <cstdint>
 #include <cstddef>
 
@@ -30,6 +37,120 @@ using atomic_queue_t = yk::exec::atomic_queue<T, typename std::allocator_traits<
 template <class T, std::size_t N, class Alloc>
 using static_atomic_queue_t = yk::exec::static_atomic_queue<T, N, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
 
+template <class T, class Alloc>
+using compact_atomic_queue_t = yk::exec::compact_atomic_queue<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+template <class T, std::size_t N, class Alloc>
+using compact_static_atomic_queue_t = yk::exec::compact_static_atomic_queue<T, N, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+template <class T, class Alloc>
+using closable_atomic_queue_t = yk::exec::closable_atomic_queue<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+template <class T, std::size_t N, class Alloc>
+using closable_static_atomic_queue_t = yk::exec::closable_static_atomic_queue<T, N, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+// pushes and pops `capacity * 3` values through the queue, checking FIFO order across wrap-arounds
+template <class Queue>
+void check_fifo(Queue& q)
+{
+  int next_push = 0, next_pop = 0;
+  for (std::size_t round = 0; round < 3; ++round) {
+    while (q.try_push(next_push)) ++next_push;
+    BOOST_REQUIRE(q.size() == q.capacity());
+
+    int val = -1;
+    while (q.try_pop(val)) {
+      BOOST_REQUIRE(val == next_pop);
+      ++next_pop;
+    }
+    BOOST_REQUIRE(q.size() == 0);
+  }
+  BOOST_REQUIRE(next_pop == next_push);
+  BOOST_REQUIRE(static_cast<std::size_t>(next_push) == q.capacity() * 3);
+}
+
+template <class Queue>
+void check_close(Queue& q)
+{
+  using traits_type = yk::exec::queue_traits<Queue>;
+  static_assert(Queue::is_closable);
+  static_assert(!traits_type::need_stop_token_for_cancel);
+
+  BOOST_REQUIRE(!q.is_closed());
+  BOOST_REQUIRE(q.push_wait(1));
+  BOOST_REQUIRE(q.try_push(2));
+
+  q.close();
+  BOOST_REQUIRE(q.is_closed());
+  BOOST_REQUIRE(!q.is_drained());
+  BOOST_REQUIRE(q.size() == 2);
+
+  // producers fail
+  BOOST_REQUIRE(q.try_push(3) == false);
+  BOOST_REQUIRE(q.push_wait(3) == false);
+  BOOST_REQUIRE(traits_type::cancelable_bounded_push(q, 3) == false);
+
+  // consumers drain the remaining values
+  int val = 0;
+  BOOST_REQUIRE(q.pop_wait(val));
+  BOOST_REQUIRE(val == 1);
+  BOOST_REQUIRE(traits_type::cancelable_pop(q, val));
+  BOOST_REQUIRE(val == 2);
+  BOOST_REQUIRE(q.is_drained());
+  BOOST_REQUIRE(q.pop_wait(val) == false);
+  BOOST_REQUIRE(q.consume_wait([](int&) noexcept {}) == false);
+  BOOST_REQUIRE(q.size() == 0);
+
+  q.open();
+  BOOST_REQUIRE(!q.is_closed());
+  BOOST_REQUIRE(q.produce_wait([](int& v) noexcept { v = 4; }));
+  BOOST_REQUIRE(q.try_push(5));
+  BOOST_REQUIRE(q.size() == 2);
+  q.clear();
+  BOOST_REQUIRE(q.size() == 0);
+  BOOST_REQUIRE(q.try_pop(val) == false);
+}
+
+template <class Queue>
+void check_concurrent_drain(Queue& q)
+{
+  constexpr int producer_count = 4;
+  constexpr int consumer_count = 4;
+
+  std::atomic<long long> pushed_sum = 0;
+  std::atomic<long long> popped_sum = 0;
+  std::atomic<int> failed_push_count = 0;
+  {
+    std::vector<std::jthread> consumers;
+    for (int i = 0; i < consumer_count; ++i) {
+      consumers.emplace_back([&] {
+        int val = 0;
+        while (q.pop_wait(val)) popped_sum += val;
+      });
+    }
+    {
+      std::vector<std::jthread> producers;
+      for (int i = 0; i < producer_count; ++i) {
+        producers.emplace_back([&, i] {
+          for (int n = 1; ; ++n) {
+            const int val = i * 1'000'000 + n;
+            if (!q.push_wait(val)) {
+              ++failed_push_count;
+              return;
+            }
+            pushed_sum += val;
+          }
+        });
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      q.close();
+    }
+  }
+  BOOST_TEST(failed_push_count == producer_count);
+  BOOST_TEST(pushed_sum == popped_sum);
+  BOOST_TEST(q.size() == 0);
+}
+
 } // anon
 
 
@@ -405,6 +526,40 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(static_queue, Alloc, allocators_t)
   { [[maybe_unused]] static_atomic_queue_t<Align_Size<128, 129>, 1, Alloc> q; }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(compact_queue, Alloc, allocators_t)
+{
+  using slot_type = yk::exec::detail::atomic_queue_slot<int, std::allocator<int>, yk::exec::atomic_queue_layout::compact>;
+  static_assert(sizeof(slot_type) < yk::hardware_destructive_interference_size);
+
+  { [[maybe_unused]] compact_atomic_queue_t<std::uint8_t, Alloc> q(1); }
+  { [[maybe_unused]] compact_atomic_queue_t<std::uint64_t, Alloc> q(1); }
+  { [[maybe_unused]] compact_atomic_queue_t<std::max_align_t, Alloc> q(1); }
+  { [[maybe_unused]] compact_atomic_queue_t<Empty, Alloc> q(1); }
+  { [[maybe_unused]] compact_atomic_queue_t<Align_Size<128, 129>, Alloc> q(1); }
+
+  { [[maybe_unused]] compact_static_atomic_queue_t<std::uint8_t, 1, Alloc> q; }
+  { [[maybe_unused]] compact_static_atomic_queue_t<std::uint64_t, 1, Alloc> q; }
+  { [[maybe_unused]] compact_static_atomic_queue_t<std::max_align_t, 1, Alloc> q; }
+  { [[maybe_unused]] compact_static_atomic_queue_t<Empty, 1, Alloc> q; }
+  { [[maybe_unused]] compact_static_atomic_queue_t<Align_Size<128, 129>, 1, Alloc> q; }
+}
+
+BOOST_AUTO_TEST_CASE(remap_stride)
+{
+  using slot_type = yk::exec::detail::atomic_queue_slot<int, std::allocator<int>, yk::exec::atomic_queue_layout::compact>;
+  constexpr std::size_t slots_per_line = yk::hardware_destructive_interference_size / sizeof(slot_type);
+
+  for (std::size_t capacity = 1; capacity <= 100; ++capacity) {
+    const auto stride = yk::exec::detail::atomic_queue_remap_stride<slot_type>(capacity);
+    if (capacity <= slots_per_line) {
+      BOOST_TEST(stride == 1u);
+    } else {
+      BOOST_TEST(stride >= slots_per_line);
+      BOOST_TEST(std::gcd(stride, capacity) == 1u);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // atomic_queue_layout
 
 
@@ -547,6 +702,54 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(blocking, Alloc, allocators_t)
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(in_place, Alloc, allocators_t)
+{
+  using record = std::array<int, 1024>;
+  atomic_queue_t<record, Alloc> q(2);
+
+  BOOST_REQUIRE(q.try_consume([](record&) {}) == false);
+
+  BOOST_REQUIRE(q.try_produce([](record& r) noexcept { r.fill(42); }) == true);
+  BOOST_REQUIRE_NO_THROW(q.produce([](record& r) noexcept { r.fill(43); }));
+  BOOST_REQUIRE(q.try_produce([](record&) noexcept {}) == false);
+  BOOST_REQUIRE(q.size() == 2);
+
+  int front = 0;
+  BOOST_REQUIRE(q.try_consume([&](record& r) { front = r.back(); }) == true);
+  BOOST_REQUIRE(front == 42);
+  BOOST_REQUIRE_NO_THROW(q.consume([&](record& r) { front = r.back(); }));
+  BOOST_REQUIRE(front == 43);
+  BOOST_REQUIRE(q.size() == 0);
+
+  // the slot is released even if the visitor throws
+  BOOST_REQUIRE(q.try_push(record{}) == true);
+  BOOST_REQUIRE_THROW((void)q.try_consume([](record&) { throw std::runtime_error{"visitor"}; }), std::runtime_error);
+  BOOST_REQUIRE(q.size() == 0);
+  BOOST_REQUIRE(q.try_push(record{}) == true);
+  BOOST_REQUIRE(q.try_push(record{}) == true);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compact, Alloc, allocators_t)
+{
+  for (std::size_t capacity : {1, 2, 3, 4, 5, 8, 12, 16, 17, 64, 100}) {
+    compact_atomic_queue_t<int, Alloc> q(capacity);
+    BOOST_REQUIRE(q.capacity() == capacity);
+    check_fifo(q);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(closable, Alloc, allocators_t)
+{
+  {
+    closable_atomic_queue_t<int, Alloc> q(4);
+    check_close(q);
+  }
+  {
+    closable_atomic_queue_t<int, Alloc> q(16);
+    check_concurrent_drain(q);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // dynamic_atomic_queue
 
 
@@ -700,4 +903,24 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(blocking, Alloc, allocators_t)
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(compact, Alloc, allocators_t)
+{
+  { compact_static_atomic_queue_t<int, 1, Alloc> q; check_fifo(q); }
+  { compact_static_atomic_queue_t<int, 12, Alloc> q; check_fifo(q); }
+  { compact_static_atomic_queue_t<int, 64, Alloc> q; check_fifo(q); }
+  { compact_static_atomic_queue_t<int, 100, Alloc> q; check_fifo(q); }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(closable, Alloc, allocators_t)
+{
+  {
+    closable_static_atomic_queue_t<int, 4, Alloc> q;
+    check_close(q);
+  }
+  {
+    closable_static_atomic_queue_t<int, 16, Alloc> q;
+    check_concurrent_drain(q);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // static_atomic_queue
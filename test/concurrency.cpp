@@ -1,17 +1,39 @@
 #include "yk/exec/cv_deque.hpp"
 #include "yk/exec/cv_vector.hpp"
+#include "yk/exec/atomic_queue.hpp"
+#include "yk/exec/lockfree_stack.hpp"
+#include "yk/exec/object_pool.hpp"
+#include "yk/exec/parking_queue.hpp"
+#include "yk/exec/port/boost_lockfree_queue.hpp"
+#include "yk/exec/priority_lane_queue.hpp"
+#include "yk/aggregate_exception.hpp"
 #include "yk/maybe_mutex.hpp"
 #include "yk/par_for_each.hpp"
+#include "yk/par_reduce.hpp"
+#include "yk/sharded_hash_map.hpp"
 
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <ctime>
+#include <exception>
 #include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <numeric>
+#include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <stop_token>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <version>
 
@@ -47,18 +69,484 @@ BOOST_AUTO_TEST_CASE(ParForEach) {
   }
   {
     sum = 0;
-    BOOST_REQUIRE_THROW(yk::ranges::for_each(yk::execution::proceed, std::execution::seq, vec, throw_func), std::runtime_error);
+    BOOST_REQUIRE_THROW(yk::ranges::for_each(yk::execution::proceed, std::execution::seq, vec, throw_func), yk::aggregate_exception);
     BOOST_TEST((sum == 10));
   }
 }
 
+// Compares the previous abort check (a shared_lock on a shared_mutex per element) with yk::for_each.
+// Run explicitly: --run_test=concurrency/ParForEachBenchmark
+BOOST_AUTO_TEST_CASE(ParForEachBenchmark, *boost::unit_test::disabled()) {
+  const auto legacy_for_each = [](auto&& policy, auto first, auto last, auto func) {
+    std::shared_mutex mtx;
+    std::exception_ptr exception;
+    std::for_each(policy, first, last, [&](auto&& arg) noexcept {
+      try {
+        {
+          std::shared_lock lock{mtx};
+          if (exception) return;
+        }
+        func(arg);
+      } catch (...) {
+        std::lock_guard lock{mtx};
+        exception = std::current_exception();
+      }
+    });
+    if (exception) std::rethrow_exception(exception);
+  };
+
+  const auto measure = [](auto&& f) {
+    const auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  };
+
+  for (std::size_t size : {100'000uz, 1'000'000uz, 10'000'000uz}) {
+    std::vector<int> vec(size, 1);
+    std::atomic<long long> sum = 0;
+    const auto func = [&](int x) { sum.fetch_add(x, std::memory_order_relaxed); };
+    const auto tiny_func = [](int& x) { x = x * 3 + 1; };
+
+    const auto legacy = measure([&] { legacy_for_each(std::execution::par, vec.begin(), vec.end(), tiny_func); });
+    const auto current = measure([&] { yk::ranges::for_each(yk::execution::abort, std::execution::par, vec, tiny_func); });
+    BOOST_TEST_MESSAGE(size << " elements: shared_mutex " << legacy << " s, atomic flag " << current << " s");
+
+    yk::ranges::for_each(yk::execution::abort, std::execution::par, vec, func);
+    BOOST_TEST(sum > 0);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(MaybeMutex) {
   static_assert(yk::xo::Lockable<yk::maybe_mutex<std::mutex, std::execution::parallel_policy>>);
   static_assert(yk::xo::Lockable<yk::maybe_mutex<std::mutex, std::execution::sequenced_policy>>);
+
+  static_assert(yk::is_parallel_v<std::execution::parallel_unsequenced_policy>);
+  static_assert(yk::is_vectorized_v<std::execution::parallel_unsequenced_policy>);
+  static_assert(!yk::is_vectorized_v<std::execution::parallel_policy>);
+#if __cpp_lib_execution >= 201902L
+  static_assert(!yk::is_parallel_v<std::execution::unsequenced_policy>);
+  static_assert(yk::is_vectorized_v<std::execution::unsequenced_policy>);
+#endif
+
+  static_assert(yk::xo::SharedLockable<yk::maybe_shared_mutex<std::shared_mutex, std::execution::parallel_policy>>);
+  static_assert(yk::xo::SharedLockable<yk::maybe_shared_mutex<std::shared_mutex, std::execution::sequenced_policy>>);
+  static_assert(std::is_empty_v<yk::maybe_shared_mutex<std::shared_mutex, std::execution::sequenced_policy>>);
+  {
+    yk::maybe_shared_mutex<std::shared_mutex, std::execution::parallel_policy> mtx;
+    std::shared_lock lock{mtx};
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MaybeAtomic) {
+  static_assert(std::is_base_of_v<std::atomic<int>, yk::maybe_atomic<int, std::execution::parallel_policy>>);
+  static_assert(std::is_base_of_v<std::atomic<int>, yk::maybe_atomic<int, std::execution::parallel_unsequenced_policy>>);
+  static_assert(sizeof(yk::maybe_atomic<int, std::execution::sequenced_policy>) == sizeof(int));
+#if __cpp_lib_execution >= 201902L
+  static_assert(std::is_base_of_v<std::atomic<int>, yk::maybe_atomic<int, std::execution::unsequenced_policy>>);
+#endif
+
+  const auto count_even = [](const auto& policy, const std::vector<int>& vec) {
+    yk::maybe_atomic<int, std::remove_cvref_t<decltype(policy)>> count = 0;
+    std::for_each(policy, vec.begin(), vec.end(), [&](int x) {
+      if (x % 2 == 0) count.fetch_add(1, std::memory_order_relaxed);
+    });
+    return count.load();
+  };
+
+  std::vector<int> vec(1000);
+  std::iota(vec.begin(), vec.end(), 0);
+  BOOST_TEST(count_even(std::execution::seq, vec) == 500);
+  BOOST_TEST(count_even(std::execution::par, vec) == 500);
+  BOOST_TEST(count_even(std::execution::par_unseq, vec) == 500);
+#if __cpp_lib_execution >= 201902L
+  BOOST_TEST(count_even(std::execution::unseq, vec) == 500);
+#endif
+
+  yk::maybe_atomic<int, std::execution::sequenced_policy> a = 1;
+  BOOST_TEST(a.exchange(2) == 1);
+  int expected = 1;
+  BOOST_TEST(!a.compare_exchange_strong(expected, 3));
+  BOOST_TEST(expected == 2);
+  BOOST_TEST(a.compare_exchange_weak(expected, 3, std::memory_order_acq_rel, std::memory_order_acquire));
+  BOOST_TEST(++a == 4);
+  BOOST_TEST((a |= 8) == 12);
+  BOOST_TEST(a.fetch_sub(2) == 12);
+  BOOST_TEST(static_cast<int>(a) == 10);
 }
 
 #endif  // __cpp_lib_parallel_algorithm
 
+BOOST_AUTO_TEST_CASE(ParForEachWorkerPool) {
+  auto pool = std::make_shared<yk::exec::worker_pool>();
+  pool->set_worker_limit(4);
+  const yk::execution::worker_pool_policy policy{pool};
+
+  std::vector<int> vec(10000);
+  std::iota(vec.begin(), vec.end(), 1);
+  constexpr long long total = 10000LL * 10001 / 2;
+
+  std::atomic<long long> sum;
+  std::atomic<int> visited;
+  const auto non_throw_func = [&](int x) {
+    sum += x;
+    ++visited;
+  };
+  const auto throw_func = [&](int x) {
+    if (x % 1000 == 0) throw std::runtime_error("");
+    sum += x;
+    ++visited;
+  };
+
+  {
+    sum = 0;
+    yk::ranges::for_each(yk::execution::abort, policy, vec, non_throw_func);
+    BOOST_TEST(sum == total);
+    BOOST_TEST(pool->launched_worker_count() == 0);
+  }
+  {
+    sum = 0;
+    visited = 0;
+    BOOST_REQUIRE_THROW(yk::ranges::for_each(yk::execution::abort, policy, vec, throw_func), std::runtime_error);
+    BOOST_TEST(visited < 10000);
+  }
+  {
+    sum = 0;
+    visited = 0;
+    BOOST_REQUIRE_THROW(yk::ranges::for_each(yk::execution::proceed, policy, vec, throw_func), yk::aggregate_exception);
+    BOOST_TEST(visited == 10000 - 10);
+    BOOST_TEST(sum == total - 1000LL * (1 + 10) * 10 / 2);
+  }
+  {
+    // forward iterators, explicit chunk size
+    std::list<int> list(vec.begin(), vec.end());
+    sum = 0;
+    yk::ranges::for_each(yk::execution::worker_pool_policy{pool, 7}, list, non_throw_func);
+    BOOST_TEST(sum == total);
+  }
+  {
+    // in place
+    yk::for_each(policy, vec.begin(), vec.end(), [](int& x) { x *= 2; });
+    BOOST_TEST(std::accumulate(vec.begin(), vec.end(), 0LL) == total * 2);
+  }
+  {
+    std::vector<int> empty;
+    yk::ranges::for_each(policy, empty, throw_func);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ParForEachSharedWorkerPool) {
+  auto pool = std::make_shared<yk::exec::worker_pool>();
+  pool->set_worker_limit(4);
+  const yk::execution::worker_pool_policy policy{pool};
+
+  std::vector<int> vec(10000);
+  std::iota(vec.begin(), vec.end(), 1);
+  constexpr long long total = 10000LL * 10001 / 2;
+
+  // a worker that outlives the calls below, like a scheduler's
+  std::atomic<bool> release = false;
+  pool->launch([&](yk::exec::thread_index_t, std::stop_token stop_token) {
+    while (!release && !stop_token.stop_requested()) std::this_thread::yield();
+  });
+
+  {
+    std::atomic<long long> sum = 0;
+    yk::ranges::for_each(policy, vec, [&](int x) { sum += x; });
+    BOOST_TEST(sum == total);
+    BOOST_TEST(pool->launched_worker_count() == 1);
+  }
+  {
+    // from one of the pool's own workers
+    std::atomic<long long> sum = 0;
+    std::atomic<bool> finished = false;
+    pool->launch([&](yk::exec::thread_index_t, std::stop_token) {
+      yk::ranges::for_each(policy, vec, [&](int x) { sum += x; });
+      finished = true;
+    });
+    while (!finished) std::this_thread::yield();
+    BOOST_TEST(sum == total);
+  }
+
+  release = true;
+  pool->halt_and_clear();
+}
+
+BOOST_AUTO_TEST_CASE(ParForEachAggregateException) {
+  auto pool = std::make_shared<yk::exec::worker_pool>();
+  pool->set_worker_limit(4);
+  const yk::execution::worker_pool_policy policy{pool};
+
+  std::vector<int> vec(10000);
+  std::iota(vec.begin(), vec.end(), 1);
+  const auto throw_func = [](int x) {
+    if (x % 1000 == 0) throw std::runtime_error(std::to_string(x));
+  };
+
+  try {
+    yk::ranges::for_each(yk::execution::proceed, policy, vec, throw_func);
+    BOOST_FAIL("unreachable");
+  } catch (const yk::aggregate_exception& e) {
+    BOOST_TEST(e.size() == 10);
+    BOOST_TEST(e.dropped_count() == 0);
+    BOOST_TEST(e.total_count() == 10);
+
+    std::vector<int> failed;
+    for (const auto& ptr : e) {
+      try {
+        std::rethrow_exception(ptr);
+      } catch (const std::runtime_error& inner) {
+        failed.push_back(std::stoi(inner.what()));
+      }
+    }
+    std::ranges::sort(failed);
+    BOOST_TEST((failed == std::vector{1000, 2000, 3000, 4000, 5000, 6000, 7000, 8000, 9000, 10000}));
+  }
+
+  // capped
+  try {
+    yk::ranges::for_each(yk::execution::proceed_policy{.max_exceptions = 3}, policy, vec, throw_func);
+    BOOST_FAIL("unreachable");
+  } catch (const yk::aggregate_exception& e) {
+    BOOST_TEST(e.size() == 3);
+    BOOST_TEST(e.dropped_count() == 7);
+    BOOST_TEST(e.total_count() == 10);
+  }
+
+  try {
+    yk::ranges::for_each(yk::execution::proceed_policy{.max_exceptions = 0}, policy, vec, throw_func);
+    BOOST_FAIL("unreachable");
+  } catch (const yk::aggregate_exception& e) {
+    BOOST_TEST(e.size() == 0);
+    BOOST_TEST(e.dropped_count() == 10);
+  }
+
+  // no failure, no exception
+  BOOST_REQUIRE_NO_THROW(yk::ranges::for_each(yk::execution::proceed, policy, vec, [](int) {}));
+}
+
+BOOST_AUTO_TEST_CASE(ParReduce) {
+  auto pool = std::make_shared<yk::exec::worker_pool>();
+  pool->set_worker_limit(4);
+  const yk::execution::worker_pool_policy policy{pool};
+
+  std::vector<int> vec(10000);
+  std::iota(vec.begin(), vec.end(), 1);
+  constexpr long long total = 10000LL * 10001 / 2;
+
+  const auto square = [](int x) { return static_cast<long long>(x) * x; };
+  constexpr long long square_total = 10000LL * 10001 * 20001 / 6;
+
+  BOOST_TEST(yk::reduce(policy, vec.begin(), vec.end(), 0LL) == total);
+  BOOST_TEST(yk::ranges::reduce(policy, vec, 5LL) == total + 5);
+  BOOST_TEST(yk::ranges::reduce(policy, vec, 0, [](int a, int b) { return std::max(a, b); }) == 10000);
+  BOOST_TEST(yk::ranges::transform_reduce(policy, vec, 0LL, std::plus<>{}, square) == square_total);
+  BOOST_TEST(yk::ranges::transform_reduce(yk::execution::worker_pool_policy{pool, 3}, std::list<int>(vec.begin(), vec.end()), 0LL, std::plus<>{}, square) ==
+             square_total);
+  BOOST_TEST(yk::ranges::reduce(policy, std::vector<int>{}, 42) == 42);
+
+  std::atomic<int> visited = 0;
+  const auto throw_func = [&](int x) -> long long {
+    ++visited;
+    if (x % 1000 == 0) throw std::runtime_error("");
+    return x;
+  };
+  BOOST_REQUIRE_THROW((void)yk::ranges::transform_reduce(yk::execution::abort, policy, vec, 0LL, std::plus<>{}, throw_func), std::runtime_error);
+  BOOST_TEST(visited < 10000);
+  visited = 0;
+  BOOST_REQUIRE_THROW((void)yk::ranges::transform_reduce(yk::execution::proceed, policy, vec, 0LL, std::plus<>{}, throw_func), yk::aggregate_exception);
+  BOOST_TEST(visited == 10000);
+
+  {
+    std::atomic<long long> sum = 0;
+    const auto it = yk::for_each_n(policy, vec.begin(), 100, [&](int x) { sum += x; });
+    BOOST_TEST((it == vec.begin() + 100));
+    BOOST_TEST(sum == 100LL * 101 / 2);
+  }
+  {
+    std::atomic<long long> sum = 0;
+    const auto it = yk::ranges::for_each_n(yk::execution::proceed, policy, vec.begin(), 0, [&](int x) { sum += x; });
+    BOOST_TEST((it == vec.begin()));
+    BOOST_TEST(sum == 0);
+  }
+
+#if __cpp_lib_parallel_algorithm >= 201603L
+  BOOST_TEST(yk::ranges::reduce(std::execution::par, vec, 0LL) == total);
+  BOOST_TEST(yk::ranges::transform_reduce(yk::execution::proceed, std::execution::seq, vec, 0LL, std::plus<>{}, square) == square_total);
+  BOOST_REQUIRE_THROW((void)yk::ranges::transform_reduce(std::execution::par, vec, 0LL, std::plus<>{}, throw_func), std::runtime_error);
+  {
+    std::atomic<long long> sum = 0;
+    yk::for_each_n(std::execution::par, vec.begin(), 10, [&](int x) { sum += x; });
+    BOOST_TEST(sum == 55);
+  }
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(ShardedHashMap) {
+  BOOST_TEST((yk::sharded_hash_map<int, int>(5).shard_count() == 8));
+  BOOST_TEST((yk::sharded_hash_map<int, int>(0).shard_count() == 1));
+  BOOST_TEST((std::has_single_bit(yk::sharded_hash_map<int, int>().shard_count())));
+
+  for (std::size_t shard_count : {1uz, 16uz}) {
+    yk::sharded_hash_map<std::string, int> map(shard_count);
+    BOOST_TEST(map.empty());
+    BOOST_TEST(map.try_emplace("a", 1));
+    BOOST_TEST(!map.try_emplace("a", 2));
+    BOOST_TEST(map.emplace("b", 2));
+    BOOST_TEST(map.insert({"c", 3}));
+    BOOST_TEST(!map.insert_or_assign("c", 30));
+    BOOST_TEST(map.size() == 3);
+    BOOST_TEST((map.get("a") == std::optional{1}));
+    BOOST_TEST((map.get("c") == std::optional{30}));
+    BOOST_TEST(!map.get("d").has_value());
+    BOOST_TEST(map.contains("b"));
+
+    BOOST_TEST(map.visit("b", [](auto& kv) { kv.second *= 10; }));
+    BOOST_TEST(!map.visit("d", [](auto&) { BOOST_FAIL("unreachable"); }));
+    BOOST_TEST(map.cvisit("b", [](const auto& kv) { BOOST_TEST(kv.second == 20); }));
+
+    BOOST_TEST(map.erase("a") == 1);
+    BOOST_TEST(map.erase("a") == 0);
+    BOOST_TEST(map.count("a") == 0);
+
+    std::size_t total = 0;
+    map.cfor_each_shard([&](const auto& shard) { total += shard.size(); });
+    BOOST_TEST(total == 2);
+
+    map.clear();
+    BOOST_TEST(map.empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ShardedHashMapConcurrent) {
+  constexpr int thread_count = 8;
+  constexpr int per_thread = 20000;
+  constexpr int key_count = 1000;
+
+  yk::sharded_hash_map<int, int> map(16);
+  map.reserve(key_count);
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          map.try_emplace_or_visit((t + i) % key_count, [](auto& kv) { ++kv.second; }, 1);
+          if (i % 7 == 0) (void)map.contains(i % key_count);
+        }
+      });
+    }
+  }
+  BOOST_TEST(map.size() == key_count);
+
+  std::atomic<long long> sum = 0;
+  std::atomic<std::size_t> size = 0;
+  auto pool = std::make_shared<yk::exec::worker_pool>();
+  pool->set_worker_limit(4);
+  map.cfor_each_shard(yk::execution::worker_pool_policy{pool}, [&](const auto& shard) {
+    for (const auto& [key, value] : shard) sum += value;
+    size += shard.size();
+  });
+  BOOST_TEST(sum == static_cast<long long>(thread_count) * per_thread);
+  BOOST_TEST(size == key_count);
+
+  // every key was hit equally often
+  std::atomic<bool> uniform = true;
+  map.for_each_shard(yk::execution::worker_pool_policy{pool}, [&](auto& shard) {
+    for (auto& [key, value] : shard) {
+      if (value != thread_count * per_thread / key_count) uniform = false;
+      value = 0;
+    }
+  });
+  BOOST_TEST(uniform);
+  BOOST_TEST((map.get(0) == std::optional{0}));
+
+#if __cpp_lib_parallel_algorithm >= 201603L
+  std::atomic<std::size_t> shard_visits = 0;
+  map.for_each_shard(std::execution::par, [&](auto&) { ++shard_visits; });
+  BOOST_TEST(shard_visits == map.shard_count());
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(ShardedHashMapInsertBuffer) {
+  using map_type = yk::sharded_hash_map<int, std::string>;
+  map_type map(8);
+
+  {
+    map_type::insert_buffer buffer(map, 1000);
+    buffer.try_emplace(1, "one");
+    buffer.emplace(2, "two");
+    buffer.insert({3, "three"});
+    BOOST_TEST(map.empty());  // staged only
+
+    buffer.flush();
+    BOOST_TEST(map.size() == 3);
+
+    buffer.try_emplace(1, "uno");  // already present: dropped
+    buffer.try_emplace(4, "four");
+  }  // flushed here
+  BOOST_TEST(map.size() == 4);
+  BOOST_TEST((map.get(1) == std::optional<std::string>{"one"}));
+  BOOST_TEST((map.get(4) == std::optional<std::string>{"four"}));
+
+  constexpr int thread_count = 8;
+  constexpr int per_thread = 10000;
+  map.clear();
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&, t] {
+        map_type::insert_buffer buffer(map, 32);
+        // half of the keys are shared with the next thread
+        for (int i = 0; i < per_thread; ++i) buffer.try_emplace(t * per_thread / 2 + i, std::to_string(t));
+      });
+    }
+  }
+  BOOST_TEST(map.size() == static_cast<std::size_t>((thread_count + 1) * per_thread / 2));
+}
+
+// Run explicitly: --run_test=concurrency/ShardedHashMapBenchmark
+BOOST_AUTO_TEST_CASE(ShardedHashMapBenchmark, *boost::unit_test::disabled()) {
+  constexpr int thread_count = 8;
+  constexpr int per_thread = 500'000;
+
+  const auto measure = [](auto&& f) {
+    const auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  };
+  const auto run_threads = [&](auto&& f) {
+    return measure([&] {
+      std::vector<std::jthread> threads;
+      for (int t = 0; t < thread_count; ++t) threads.emplace_back([&, t] { f(t); });
+    });
+  };
+  const auto key_of = [](int t, int i) { return t * per_thread + i; };
+
+  std::mutex mtx;
+  std::unordered_map<int, int> locked_map;
+  const auto locked = run_threads([&](int t) {
+    for (int i = 0; i < per_thread; ++i) {
+      std::lock_guard lock{mtx};
+      locked_map.try_emplace(key_of(t, i), i);
+    }
+  });
+
+  yk::sharded_hash_map<int, int> sharded_map;
+  const auto sharded = run_threads([&](int t) {
+    for (int i = 0; i < per_thread; ++i) sharded_map.try_emplace(key_of(t, i), i);
+  });
+
+  yk::sharded_hash_map<int, int> buffered_map;
+  const auto buffered = run_threads([&](int t) {
+    yk::sharded_hash_map<int, int>::insert_buffer buffer(buffered_map);
+    for (int i = 0; i < per_thread; ++i) buffer.try_emplace(key_of(t, i), i);
+  });
+
+  BOOST_TEST(locked_map.size() == sharded_map.size());
+  BOOST_TEST(locked_map.size() == buffered_map.size());
+  BOOST_TEST_MESSAGE(thread_count << " threads x " << per_thread << " inserts: std::mutex + std::unordered_map " << locked << " s, sharded " << sharded
+                                  << " s, sharded with insert_buffer " << buffered << " s");
+}
+
 BOOST_AUTO_TEST_CASE(ConcurrentVector) {
   // stack-like pool
   {
@@ -625,4 +1113,403 @@ BOOST_AUTO_TEST_CASE(ConcurrentDeque) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(PriorityLaneQueue) {
+  // higher lanes first
+  {
+    yk::exec::priority_lane_queue<yk::exec::mpmc_cv_deque<int, yk::exec::cv_queue_flag::queue_based_push_pop>, 3> queue;
+    BOOST_TEST(queue.try_push(yk::exec::priority{2}, 20));
+    BOOST_TEST(queue.try_push(21)); // lowest lane by default
+    BOOST_TEST(queue.try_push(yk::exec::priority{1}, 10));
+    BOOST_TEST(queue.try_push(yk::exec::priority{0}, 0));
+    BOOST_TEST(queue.size() == 4);
+    BOOST_CHECK_THROW((void)queue.try_push(yk::exec::priority{3}, 30), std::out_of_range);
+
+    std::vector<int> result;
+    int value = -1;
+    while (queue.try_pop(value)) result.push_back(value);
+    BOOST_TEST((result == std::vector<int>{0, 10, 20, 21}));
+  }
+  // bounded lanes
+  {
+    yk::exec::priority_lane_queue<yk::exec::atomic_queue<int>, 2> queue(2);
+    BOOST_TEST(queue.try_push(yk::exec::priority{0}, 0));
+    BOOST_TEST(queue.try_push(yk::exec::priority{0}, 1));
+    BOOST_TEST(!queue.try_push(yk::exec::priority{0}, 2));
+    BOOST_TEST(queue.try_push(yk::exec::priority{1}, 10));
+  }
+  // starvation protection
+  {
+    yk::exec::priority_lane_queue<yk::exec::atomic_queue<int>, 2> queue(64);
+    queue.set_starvation_period(4);
+    for (int i = 0; i < 16; ++i) {
+      BOOST_TEST(queue.try_push(yk::exec::priority{0}, 0));
+      BOOST_TEST(queue.try_push(yk::exec::priority{1}, 1));
+    }
+
+    int low = 0;
+    for (int i = 0; i < 16; ++i) {
+      int value = -1;
+      BOOST_TEST(queue.try_pop(value));
+      low += value;
+    }
+    BOOST_TEST(low == 4);
+  }
+#if __cpp_lib_jthread >= 201911L
+  // via queue_traits
+  {
+    using Queue = yk::exec::priority_lane_queue<yk::exec::atomic_queue<int>, 2>;
+    using Traits = yk::exec::queue_traits<Queue>;
+    static_assert(Traits::need_stop_token_for_cancel);
+
+    Queue queue(4);
+    std::stop_source ssource;
+    BOOST_TEST(Traits::cancelable_bounded_push(ssource.get_token(), queue, 1));
+    BOOST_TEST(Traits::cancelable_bounded_push(ssource.get_token(), queue, yk::exec::priority{0}, 0));
+
+    int value = -1;
+    BOOST_TEST(Traits::cancelable_pop(ssource.get_token(), queue, value));
+    BOOST_TEST(value == 0);
+    BOOST_TEST(Traits::cancelable_pop(ssource.get_token(), queue, value));
+    BOOST_TEST(value == 1);
+
+    ssource.request_stop();
+    BOOST_TEST(!Traits::cancelable_pop(ssource.get_token(), queue, value));
+  }
+  // blocked consumers park, and are woken by a push or a stop request
+  {
+    using Queue = yk::exec::priority_lane_queue<yk::exec::mpmc_cv_deque<int, yk::exec::cv_queue_flag::queue_based_push_pop>, 2>;
+    Queue queue;
+    queue.set_spin_count(4);
+
+    std::stop_source ssource;
+    std::atomic<int> popped = -1;
+    std::jthread consumer([&] {
+      int value = -1;
+      if (queue.pop_wait(ssource.get_token(), value)) popped = value;
+    });
+    while (queue.parked_consumers() == 0) std::this_thread::yield();
+    BOOST_TEST(queue.try_push(yk::exec::priority{0}, 42));
+    consumer.join();
+    BOOST_TEST(popped == 42);
+
+    std::atomic<bool> canceled = false;
+    consumer = std::jthread([&] {
+      int value = -1;
+      canceled = !queue.pop_wait(ssource.get_token(), value);
+    });
+    while (queue.parked_consumers() == 0) std::this_thread::yield();
+    ssource.request_stop();
+    consumer.join();
+    BOOST_TEST(canceled);
+    BOOST_TEST(queue.parked_consumers() == 0);
+  }
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(ObjectPool) {
+  using pool_type = yk::exec::object_pool<std::vector<int>>;
+
+  {
+    pool_type pool(2, std::vector<int>(100));
+    BOOST_TEST(pool.capacity() == 2);
+    BOOST_TEST(pool.available() == 2);
+
+    auto a = pool.try_acquire();
+    auto b = pool.acquire();
+    BOOST_TEST(static_cast<bool>(a));
+    BOOST_TEST(static_cast<bool>(b));
+    BOOST_TEST(a->size() == 100);
+    BOOST_TEST(!pool.try_acquire()); // exhausted
+
+    int* const data = a->data();
+    a.reset();
+    BOOST_TEST(pool.available() == 1);
+    auto c = pool.try_acquire();
+    BOOST_TEST(c->data() == data); // recycled, not reallocated
+
+    pool_type::handle moved = std::move(c);
+    BOOST_TEST(!c);
+    BOOST_TEST(moved.get()->data() == data);
+  }
+
+  // handles travel through a queue and return to the pool on the consumer side
+  {
+    constexpr int count = 10000;
+    pool_type pool(8);
+    yk::exec::atomic_queue<pool_type::handle> queue(4);
+
+    std::jthread producer{[&] {
+      for (int i = 0; i < count; ++i) {
+        auto h = pool.acquire();
+        h->assign(1, i);
+        queue.push(std::move(h));
+      }
+    }};
+
+    long long sum = 0;
+    for (int i = 0; i < count; ++i) {
+      pool_type::handle h;
+      queue.pop(h);
+      sum += h->front();
+    }
+    producer.join();
+
+    BOOST_TEST(sum == static_cast<long long>(count) * (count - 1) / 2);
+    BOOST_TEST(pool.available() == 8);
+  }
+
+  // a blocked acquire() is woken by a returned object or by a stop request
+  {
+    pool_type pool(1);
+    auto held = pool.acquire();
+
+    std::stop_source ssource;
+    std::atomic<int> result = -1;
+    std::jthread waiter{[&] {
+      auto h = pool.acquire(ssource.get_token());
+      result = h ? 1 : 0;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    BOOST_TEST(result == -1);
+    ssource.request_stop();
+    waiter.join();
+    BOOST_TEST(result == 0);
+
+    result = -1;
+    std::jthread waiter2{[&] {
+      auto h = pool.acquire(std::stop_token{});
+      result = h ? 1 : 0;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    held.reset();
+    waiter2.join();
+    BOOST_TEST(result == 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LockfreeStack) {
+  BOOST_CHECK_THROW(yk::exec::lockfree_stack<int>{0}, std::invalid_argument);
+
+  // LIFO, bounded
+  {
+    yk::exec::lockfree_stack<int> stack(3);
+    BOOST_TEST(stack.capacity() == 3);
+    BOOST_TEST(stack.try_push(1));
+    BOOST_TEST(stack.try_push(2));
+    BOOST_TEST(stack.push_wait(3));
+    BOOST_TEST(!stack.try_push(4));
+    BOOST_TEST(stack.size() == 3);
+
+    std::vector<int> result;
+    int value = -1;
+    while (stack.try_pop(value)) result.push_back(value);
+    BOOST_TEST((result == std::vector<int>{3, 2, 1}));
+    BOOST_TEST(stack.size() == 0);
+  }
+  // a throwing move assignment leaves the value on the stack
+  {
+    struct throwing
+    {
+      int* live = nullptr;
+      bool throw_on_move = false;
+
+      throwing() = default;
+      throwing(int* live, bool throw_on_move) : live(live), throw_on_move(throw_on_move) { ++*live; }
+      throwing(const throwing&) = delete;
+      throwing(throwing&& other) noexcept : live(std::exchange(other.live, nullptr)), throw_on_move(other.throw_on_move) {}
+      ~throwing() { if (live) --*live; }
+
+      throwing& operator=(throwing&& other)
+      {
+        if (other.throw_on_move) throw std::runtime_error("move");
+        if (live) --*live;
+        live = std::exchange(other.live, nullptr);
+        return *this;
+      }
+    };
+
+    int live = 0;
+    {
+      yk::exec::lockfree_stack<throwing> stack(1);
+      BOOST_TEST(stack.try_push(&live, true));
+      throwing value;
+      BOOST_CHECK_THROW((void)stack.try_pop(value), std::runtime_error);
+      BOOST_TEST(stack.size() == 1);
+      BOOST_TEST(!stack.try_push(&live, false)); // still full
+    }
+    BOOST_TEST(live == 0); // destroyed with the stack
+  }
+  // close() wakes the blocked threads, same as cv_queue
+  {
+    yk::exec::lockfree_stack<int> stack(1);
+    std::atomic<bool> failed = false;
+    {
+      std::jthread consumer{[&] {
+        int value;
+        failed = !stack.pop_wait(value);
+      }};
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      stack.close();
+    }
+    BOOST_TEST(failed);
+    BOOST_TEST(stack.is_closed());
+    BOOST_TEST(!stack.try_push(2));
+    int value;
+    BOOST_TEST(!stack.pop_wait(value));
+
+    stack.open();
+    BOOST_TEST(stack.push_wait(2));
+    BOOST_TEST(!stack.try_push(3));
+    BOOST_TEST(stack.pop_wait(value));
+    BOOST_TEST(value == 2);
+  }
+  // MPMC
+  {
+    constexpr int per_thread = 20000;
+    constexpr int thread_count = 4;
+    yk::exec::lockfree_stack<int> stack(16);
+    std::atomic<long long> sum = 0;
+    std::atomic<int> failed = 0;
+    {
+      std::vector<std::jthread> threads;
+      for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&] {
+          for (int i = 0; i < per_thread; ++i) {
+            if (!stack.push_wait(i)) ++failed;
+          }
+        });
+        threads.emplace_back([&] {
+          for (int i = 0; i < per_thread; ++i) {
+            int value = 0;
+            if (!stack.pop_wait(value)) {
+              ++failed;
+              continue;
+            }
+            sum += value;
+          }
+        });
+      }
+    }
+    BOOST_TEST(failed == 0);
+    BOOST_TEST(sum == static_cast<long long>(thread_count) * per_thread * (per_thread - 1) / 2);
+    BOOST_TEST(stack.size() == 0);
+  }
+  // via queue_traits
+  {
+    using Traits = yk::exec::queue_traits<yk::exec::lockfree_stack<std::vector<int>>>;
+    static_assert(!Traits::need_stop_token_for_cancel);
+
+    yk::exec::lockfree_stack<std::vector<int>> stack(2);
+    BOOST_TEST(Traits::cancelable_bounded_push(stack, 3, 42));
+    std::vector<int> value;
+    BOOST_TEST(Traits::cancelable_pop(stack, value));
+    BOOST_TEST((value == std::vector<int>{42, 42, 42}));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ParkingQueue) {
+  using Queue = yk::exec::parking_queue<boost::lockfree::queue<int>>;
+  using Traits = yk::exec::queue_traits<Queue>;
+  static_assert(Traits::need_stop_token_for_cancel);
+
+  // non-blocking
+  {
+    yk::exec::parking_queue<yk::exec::atomic_queue<int>> queue(1);
+    BOOST_TEST(queue.try_push(1));
+    BOOST_TEST(!queue.try_push(2));
+    int value = -1;
+    BOOST_TEST(queue.try_pop(value));
+    BOOST_TEST(value == 1);
+    BOOST_TEST(!queue.try_pop(value));
+  }
+
+  // parked consumers wake up on push, and on stop request
+  {
+    Queue queue(16);
+    queue.set_spin_count(0);
+    std::stop_source ssource;
+    std::atomic<int> popped = 0, stopped = 0;
+    {
+      std::vector<std::jthread> consumers;
+      for (int i = 0; i < 4; ++i) {
+        consumers.emplace_back([&] {
+          int value;
+          while (Traits::cancelable_pop(ssource.get_token(), queue, value)) ++popped;
+          ++stopped;
+        });
+      }
+
+      while (queue.parked_consumers() < 4) std::this_thread::yield();
+      for (int i = 0; i < 100; ++i) {
+        BOOST_TEST(Traits::cancelable_bounded_push(ssource.get_token(), queue, i));
+      }
+      while (popped < 100) std::this_thread::yield();
+
+      ssource.request_stop();
+    }
+    BOOST_TEST(popped == 100);
+    BOOST_TEST(stopped == 4);
+  }
+
+  // parked producer wakes up on pop
+  {
+    yk::exec::parking_queue<yk::exec::atomic_queue<int>> queue(1);
+    std::stop_source ssource;
+    BOOST_TEST(queue.push_wait(ssource.get_token(), 1));
+
+    std::jthread producer{[&] { (void)queue.push_wait(ssource.get_token(), 2); }};
+    while (queue.parked_producers() < 1) std::this_thread::yield();
+
+    int value = -1;
+    BOOST_TEST(queue.pop_wait(ssource.get_token(), value));
+    BOOST_TEST(value == 1);
+    producer.join();
+    BOOST_TEST(queue.pop_wait(ssource.get_token(), value));
+    BOOST_TEST(value == 2);
+  }
+}
+
+// Compares the plain boost.lockfree port (spinning) with parking_queue.
+// Run explicitly: --run_test=concurrency/ParkingQueueBenchmark
+BOOST_AUTO_TEST_CASE(ParkingQueueBenchmark, *boost::unit_test::disabled()) {
+  constexpr int consumer_count = 4;
+  constexpr int item_count = 1'000'000;
+
+  const auto run = [&]<class Queue>(std::type_identity<Queue>, const char* name) {
+    using Traits = yk::exec::queue_traits<Queue>;
+    Queue queue(1024);
+    std::stop_source ssource;
+    std::atomic<int> popped = 0;
+
+    std::vector<std::jthread> consumers;
+    for (int i = 0; i < consumer_count; ++i) {
+      consumers.emplace_back([&] {
+        int value;
+        while (Traits::cancelable_pop(ssource.get_token(), queue, value)) ++popped;
+      });
+    }
+
+    // idle: consumers wait on an empty queue
+    const auto idle_cpu_begin = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds{500});
+    const auto idle_cpu = static_cast<double>(std::clock() - idle_cpu_begin) / CLOCKS_PER_SEC;
+
+    // busy: one producer
+    const auto busy_begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < item_count; ++i) {
+      (void)Traits::cancelable_bounded_push(ssource.get_token(), queue, i);
+    }
+    while (popped < item_count) std::this_thread::yield();
+    const auto busy = std::chrono::duration<double>(std::chrono::steady_clock::now() - busy_begin).count();
+
+    ssource.request_stop();
+    consumers.clear();
+
+    BOOST_TEST_MESSAGE(name << ": idle CPU " << idle_cpu << " s per 0.5 s wall, " << item_count << " items in " << busy << " s");
+  };
+
+  run(std::type_identity<boost::lockfree::queue<int>>{}, "spin");
+  run(std::type_identity<yk::exec::parking_queue<boost::lockfree::queue<int>>>{}, "parking");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,9 +1,17 @@
 #include <yk/fixed_string.hpp>
+#include <yk/perfect_hash_map.hpp>
 
 #include <boost/test/unit_test.hpp>
 
+#include <boost/core/ignore_unused.hpp>
+
 #include <algorithm>
+#include <array>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <utility>
 
 BOOST_AUTO_TEST_SUITE(fixed_string)
 
@@ -14,4 +22,57 @@ BOOST_AUTO_TEST_CASE(fixed_string)
   BOOST_TEST((std::ranges::equal(str, "foobar"sv)));
 }
 
+BOOST_AUTO_TEST_CASE(perfect_hash_map)
+{
+  using namespace std::string_view_literals;
+
+  static constexpr auto map = yk::make_perfect_hash_map(std::array{
+      std::pair{"apple"sv, 1},
+      std::pair{"banana"sv, 2},
+      std::pair{"cherry"sv, 3},
+      std::pair{""sv, 4},
+  });
+  static_assert(map.size() == 4);
+  static_assert(map.find("banana")->second == 2);
+  static_assert(map.at("") == 4);
+  static_assert(!map.contains("banan"));
+  static_assert(!map.contains("durian"));
+
+  BOOST_TEST(map.at("apple") == 1);
+  BOOST_TEST(map.at(std::string("cherry")) == 3);
+  BOOST_TEST((map.find("grape") == map.end()));
+  BOOST_CHECK_THROW(boost::ignore_unused(map.at("grape")), std::out_of_range);
+
+  static constexpr auto empty = yk::make_perfect_hash_map(std::array<std::pair<std::string_view, int>, 0>{});
+  static_assert(empty.empty());
+  static_assert(!empty.contains(""));
+
+  // every key lands on its own slot, for more keys than buckets
+  static constexpr auto numbers = [] {
+    constexpr std::string_view chars = "abcdefghijklmnopqrstuvwxyz0123";
+    std::array<std::pair<std::string_view, int>, 100> entries;
+    for (int i = 0; i < 100; ++i) entries[i] = {chars.substr(i % 26, 1 + i / 26), i};
+    return entries;
+  }();
+  BOOST_TEST((std::set<std::pair<std::string_view, int>>(numbers.begin(), numbers.end()).size() == 100));
+  static constexpr auto numbers_map = yk::make_perfect_hash_map(numbers);
+  for (const auto& [key, value] : numbers) {
+    BOOST_TEST(numbers_map.at(key) == value);
+  }
+
+  BOOST_CHECK_THROW(boost::ignore_unused(yk::make_perfect_hash_map(std::array{std::pair{"a"sv, 1}, std::pair{"a"sv, 2}})), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(perfect_hash_index)
+{
+  constexpr auto& index = yk::perfect_hash_index<"foo", "bar", "baz">;
+  static_assert(index.find("foo")->second == 0);
+  static_assert(index.find("bar")->second == 1);
+  static_assert(index.find("baz")->second == 2);
+  static_assert(!index.contains("qux"));
+
+  constexpr yk::basic_fixed_string key = "baz";
+  BOOST_TEST(index.at(key) == 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,312 @@
+#include "yk/flat_hash_map.hpp"
+#include "yk/flat_hash_set.hpp"
+#include "yk/hash/proxy_hash.hpp"
+#include "yk/hash/string_hash.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flat_hash_map_test {
+
+struct Counted {
+  static inline int alive = 0;
+
+  int value;
+
+  explicit Counted(int v) : value(v) { ++alive; }
+  Counted(const Counted& other) : value(other.value) { ++alive; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++alive; }
+  Counted& operator=(const Counted&) = default;
+  ~Counted() { --alive; }
+
+  bool operator==(const Counted&) const = default;
+};
+
+struct Person {
+  std::string name;
+  int age;
+};
+
+struct PersonNameEqual {
+  using is_transparent = void;
+
+  static const std::string& name(const Person& p) noexcept { return p.name; }
+  static const std::string& name(const std::string& s) noexcept { return s; }
+
+  bool operator()(const auto& a, const auto& b) const noexcept { return name(a) == name(b); }
+};
+
+// every key collides on the same probe sequence
+struct ConstantHash {
+  std::size_t operator()(int) const noexcept { return 42; }
+};
+
+}  // namespace flat_hash_map_test
+
+BOOST_AUTO_TEST_SUITE(flat_hash_map)
+
+BOOST_AUTO_TEST_CASE(Basic) {
+  yk::flat_hash_map<int, std::string> map;
+  BOOST_TEST(map.empty());
+  BOOST_TEST(map.bucket_count() == 0);
+  BOOST_TEST((map.find(1) == map.end()));
+  BOOST_TEST((map.begin() == map.end()));
+
+  BOOST_TEST(map.insert({1, "one"}).second);
+  BOOST_TEST(!map.insert({1, "uno"}).second);
+  BOOST_TEST(map.emplace(2, "two").second);
+  BOOST_TEST(map.try_emplace(3, 3, 'x').second);
+  BOOST_TEST(!map.try_emplace(3, "unused").second);
+  map[4] = "four";
+  BOOST_TEST(map.insert_or_assign(4, "FOUR").second == false);
+
+  BOOST_TEST(map.size() == 4);
+  BOOST_TEST(map.at(1) == "one");
+  BOOST_TEST(map.at(3) == "xxx");
+  BOOST_TEST(map.at(4) == "FOUR");
+  BOOST_CHECK_THROW((void)map.at(5), std::out_of_range);
+  BOOST_TEST(map.contains(2));
+  BOOST_TEST(map.count(5) == 0);
+
+  BOOST_TEST(map.erase(2) == 1);
+  BOOST_TEST(map.erase(2) == 0);
+  BOOST_TEST(!map.contains(2));
+  BOOST_TEST(map.size() == 3);
+
+  int sum = 0;
+  for (const auto& [key, value] : map) sum += key;
+  BOOST_TEST(sum == 1 + 3 + 4);
+
+  const auto copy = map;
+  BOOST_TEST((copy == map));
+  map[1] = "changed";
+  BOOST_TEST((copy != map));
+
+  auto moved = std::move(map);
+  BOOST_TEST(moved.size() == 3);
+  BOOST_TEST(map.empty());  // NOLINT(bugprone-use-after-move)
+
+  moved.clear();
+  BOOST_TEST(moved.empty());
+  BOOST_TEST((moved.begin() == moved.end()));
+  BOOST_TEST(moved.bucket_count() != 0);
+
+  const yk::flat_hash_map<int, int> il{{1, 10}, {2, 20}, {1, 30}};
+  BOOST_TEST(il.size() == 2);
+  BOOST_TEST(il.at(1) == 10);
+}
+
+BOOST_AUTO_TEST_CASE(EraseWhileIterating) {
+  yk::flat_hash_map<int, int> map;
+  for (int i = 0; i < 1000; ++i) map[i] = i;
+
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->first % 3 == 0) {
+      it = map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  BOOST_TEST(map.size() == 666);
+  BOOST_TEST(std::ranges::none_of(map, [](const auto& kv) { return kv.first % 3 == 0; }));
+}
+
+// random operations against std::unordered_map; small key space so that tombstones pile up
+BOOST_AUTO_TEST_CASE(Randomized) {
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int> key_dist(0, 2000);
+  std::uniform_int_distribution<int> op_dist(0, 9);
+
+  yk::flat_hash_map<int, int> map;
+  std::unordered_map<int, int> expected;
+
+  for (int i = 0; i < 200'000; ++i) {
+    const int key = key_dist(rng);
+    switch (op_dist(rng)) {
+      case 0:
+      case 1:
+      case 2:
+      case 3: {
+        const bool inserted = map.try_emplace(key, i).second;
+        BOOST_REQUIRE(inserted == expected.try_emplace(key, i).second);
+        break;
+      }
+      case 4:
+      case 5:
+      case 6:
+        BOOST_REQUIRE(map.erase(key) == expected.erase(key));
+        break;
+      default: {
+        const auto it = map.find(key);
+        const auto expected_it = expected.find(key);
+        BOOST_REQUIRE((it == map.end()) == (expected_it == expected.end()));
+        if (it != map.end()) BOOST_REQUIRE(it->second == expected_it->second);
+        break;
+      }
+    }
+    BOOST_REQUIRE(map.size() == expected.size());
+  }
+
+  BOOST_TEST(static_cast<std::size_t>(std::ranges::distance(map)) == expected.size());
+  for (const auto& [key, value] : expected) BOOST_REQUIRE(map.at(key) == value);
+
+  // everything collides
+  yk::flat_hash_map<int, int, flat_hash_map_test::ConstantHash> colliding;
+  for (int i = 0; i < 100; ++i) colliding[i] = i;
+  for (int i = 0; i < 100; i += 2) colliding.erase(i);
+  BOOST_TEST(colliding.size() == 50);
+  for (int i = 0; i < 100; ++i) BOOST_REQUIRE(colliding.contains(i) == (i % 2 == 1));
+}
+
+BOOST_AUTO_TEST_CASE(ReserveAndRehash) {
+  yk::flat_hash_map<int, int> map;
+  map.reserve(1000);
+  const auto bucket_count = map.bucket_count();
+  BOOST_TEST(bucket_count * map.max_load_factor() >= 1000);
+
+  for (int i = 0; i < 1000; ++i) map[i] = i;
+  BOOST_TEST(map.bucket_count() == bucket_count);
+  BOOST_TEST(map.load_factor() <= map.max_load_factor());
+
+  map.rehash(bucket_count * 4);
+  BOOST_TEST(map.bucket_count() >= bucket_count * 4);
+  for (int i = 0; i < 1000; ++i) BOOST_REQUIRE(map.at(i) == i);
+
+  // shrinks to fit the elements
+  for (int i = 10; i < 1000; ++i) map.erase(i);
+  map.rehash(0);
+  BOOST_TEST(map.bucket_count() == 16);
+  for (int i = 0; i < 10; ++i) BOOST_REQUIRE(map.at(i) == i);
+
+  map.clear();
+  map.rehash(0);
+  BOOST_TEST(map.bucket_count() == 0);
+
+  const yk::flat_hash_map<int, int> presized(100);
+  BOOST_TEST(presized.bucket_count() >= 100);
+}
+
+BOOST_AUTO_TEST_CASE(Lifetime) {
+  using flat_hash_map_test::Counted;
+  {
+    yk::flat_hash_map<int, Counted> map;
+    for (int i = 0; i < 500; ++i) map.try_emplace(i, i);
+    BOOST_TEST(Counted::alive == 500);
+    for (int i = 0; i < 500; i += 2) map.erase(i);
+    BOOST_TEST(Counted::alive == 250);
+
+    auto copy = map;
+    BOOST_TEST(Counted::alive == 500);
+    copy = std::move(map);
+    BOOST_TEST(Counted::alive == 250);
+  }
+  BOOST_TEST(Counted::alive == 0);
+
+  yk::flat_hash_map<std::string, std::unique_ptr<int>> move_only;
+  move_only.try_emplace("a", std::make_unique<int>(1));
+  move_only["b"] = std::make_unique<int>(2);
+  for (int i = 0; i < 100; ++i) move_only.try_emplace(std::to_string(i), std::make_unique<int>(i));
+  BOOST_TEST(*move_only.at("a") == 1);
+  BOOST_TEST(*move_only.at("b") == 2);
+  BOOST_TEST(*move_only.at("99") == 99);
+}
+
+BOOST_AUTO_TEST_CASE(HeterogeneousLookup) {
+  using namespace std::string_view_literals;
+
+  yk::flat_hash_map<std::string, int, yk::string_hash, std::equal_to<>> map;
+  map.try_emplace("foo"sv, 1);  // constructs std::string only when inserting
+  map["bar"] = 2;
+
+  BOOST_TEST(map.contains("foo"sv));
+  BOOST_TEST(map.contains("bar"));
+  BOOST_TEST(map.at("foo"sv) == 1);
+  BOOST_TEST(map.count(std::string("bar")) == 1);
+  BOOST_TEST(map.erase("foo"sv) == 1);
+  BOOST_TEST(!map.contains("foo"));
+
+  using flat_hash_map_test::Person;
+  yk::flat_hash_set<Person, yk::proxy_hash<Person, &Person::name>, flat_hash_map_test::PersonNameEqual> people;
+  people.insert(Person{"alice", 20});
+  people.insert(Person{"bob", 30});
+  BOOST_TEST(!people.insert(Person{"alice", 99}).second);
+  BOOST_TEST(people.find(std::string("alice"))->age == 20);
+  BOOST_TEST(!people.contains(std::string("carol")));
+}
+
+BOOST_AUTO_TEST_CASE(Set) {
+  yk::flat_hash_set<std::string> set{"a", "b", "c"};
+  BOOST_TEST(set.size() == 3);
+  BOOST_TEST(!set.insert("a").second);
+  BOOST_TEST(set.emplace(3, 'd').second);
+  BOOST_TEST(set.contains("ddd"));
+  BOOST_TEST(set.erase("b") == 1);
+
+  std::vector<std::string> elems(set.begin(), set.end());
+  std::ranges::sort(elems);
+  BOOST_TEST((elems == std::vector<std::string>{"a", "c", "ddd"}));
+}
+
+// Run explicitly: --run_test=flat_hash_map/FlatHashMapBenchmark
+BOOST_AUTO_TEST_CASE(FlatHashMapBenchmark, *boost::unit_test::disabled()) {
+  const auto measure = [](auto&& f) {
+    const auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  };
+
+  const auto run = [&]<class Map>(const char* name, const auto& keys, const auto& missing_keys) {
+    Map map;
+    const auto insert = measure([&] {
+      for (std::size_t i = 0; i < keys.size(); ++i) map.try_emplace(keys[i], i);
+    });
+
+    std::size_t found = 0;
+    const auto hit = measure([&] {
+      for (int round = 0; round < 4; ++round) {
+        for (const auto& key : keys) found += map.find(key)->second;
+      }
+    });
+    const auto miss = measure([&] {
+      for (int round = 0; round < 4; ++round) {
+        for (const auto& key : missing_keys) found += map.contains(key);
+      }
+    });
+    BOOST_TEST_MESSAGE(name << ": insert " << insert << " s, hit " << hit << " s, miss " << miss << " s (" << found << ")");
+  };
+
+  std::mt19937_64 rng(42);
+  for (std::size_t size : {1'000uz, 100'000uz, 1'000'000uz}) {
+    std::vector<std::uint64_t> keys(size), missing_keys(size);
+    for (auto& key : keys) key = rng() | 1;
+    for (auto& key : missing_keys) key = rng() & ~std::uint64_t{1};
+
+    BOOST_TEST_MESSAGE(size << " integer keys");
+    run.template operator()<std::unordered_map<std::uint64_t, std::size_t>>("  std::unordered_map", keys, missing_keys);
+    run.template operator()<yk::flat_hash_map<std::uint64_t, std::size_t>>("  yk::flat_hash_map ", keys, missing_keys);
+
+    std::vector<std::string> str_keys, missing_str_keys;
+    for (auto key : keys) str_keys.push_back("key:" + std::to_string(key));
+    for (auto key : missing_keys) missing_str_keys.push_back("key:" + std::to_string(key));
+
+    BOOST_TEST_MESSAGE(size << " string keys");
+    run.template operator()<std::unordered_map<std::string, std::size_t, yk::string_hash, std::equal_to<>>>("  std::unordered_map", str_keys, missing_str_keys);
+    run.template operator()<yk::flat_hash_map<std::string, std::size_t, yk::string_hash, std::equal_to<>>>("  yk::flat_hash_map ", str_keys, missing_str_keys);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
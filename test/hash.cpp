@@ -1,6 +1,9 @@
 #include "yk/hash/adapt.hpp"
+#include "yk/hash/hash_append.hpp"
+#include "yk/hash/hash_bytes.hpp"
 #include "yk/hash/hash_combine.hpp"
 #include "yk/hash/hash_value_for.hpp"
+#include "yk/hash/hasher.hpp"
 #include "yk/hash/proxy_hash.hpp"
 #include "yk/hash/range.hpp"
 #include "yk/hash/string_hash.hpp"
@@ -8,13 +11,21 @@
 #include <boost/container_hash/hash.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <array>
 #include <functional>
+#include <optional>
+#include <list>
+#include <span>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_set>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include <cstddef>
+#include <cstdint>
 
 namespace hash_test {
 
@@ -27,10 +38,16 @@ struct MultiS {
   int a, b, c;
 };
 
+struct Point {
+  int x, y;
+  std::string label;
+};
+
 }  // namespace hash_test
 
 YK_ADAPT_HASH_TEMPLATE(hash_test, (S<T, Ts...>), val, { return yk::hash_value_for(val.val); }, class T, class... Ts);
 YK_ADAPT_HASH(hash_test, MultiS, val, { return yk::hash_combine(val.a, val.b, val.c); });
+YK_ADAPT_HASH_APPEND(hash_test, Point, p, p.x, p.y, p.label);
 
 BOOST_AUTO_TEST_SUITE(hash)
 BOOST_AUTO_TEST_CASE(Hash) {
@@ -80,8 +97,141 @@ BOOST_AUTO_TEST_CASE(StringHash) {
 
 BOOST_AUTO_TEST_CASE(RangeHash) {
   std::vector vec{3, 1, 4, 1, 5};
-  BOOST_TEST(yk::hash_range(vec) == yk::hash_combine(3, 1, 4, 1, 5));
   BOOST_TEST(yk::hash_combine(33, vec, 4) == yk::hash_combine(33, yk::hash_combine(3, 1, 4, 1, 5), 4));
+
+  // element-wise fallback
+  std::list list{3, 1, 4, 1, 5};
+  BOOST_TEST(yk::hash_range(list) == yk::hash_combine(3, 1, 4, 1, 5));
+  std::vector<double> doubles{3, 1, 4};  // not uniquely represented (+0.0 == -0.0)
+  BOOST_TEST(yk::hash_range(doubles) == yk::hash_combine(3.0, 1.0, 4.0));
+
+  // contiguous bulk path
+  BOOST_TEST(yk::hash_range(vec) == yk::hash_bytes(vec.data(), vec.size() * sizeof(int)));
+  BOOST_TEST(yk::hash_range(vec) == yk::hash_range(std::span<const int>(vec)));
+  BOOST_TEST(yk::hash_range(vec) != yk::hash_range(std::vector{3, 1, 4, 1, 6}));
+  BOOST_TEST(yk::hash_range(std::vector<int>{}) == yk::hash_bytes(nullptr, 0));
+}
+
+BOOST_AUTO_TEST_CASE(HashBytes) {
+  // every length class: 0, 1-3, 4-16, 17-48, > 48
+  std::vector<unsigned char> bytes(1000);
+  for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<unsigned char>(i * 31 + 7);
+
+  std::unordered_set<std::uint64_t> seen;
+  for (std::size_t len : {0, 1, 2, 3, 4, 7, 8, 15, 16, 17, 31, 48, 49, 96, 97, 1000}) {
+    const auto h = yk::hash_bytes(bytes.data(), len);
+    BOOST_TEST(h == yk::hash_bytes(bytes.data(), len));
+    BOOST_TEST(seen.insert(h).second);
+    BOOST_TEST(h != yk::hash_bytes(bytes.data(), len, 42));
+  }
+
+  // each byte matters
+  const auto base = yk::hash_bytes(bytes.data(), bytes.size());
+  for (std::size_t i : {0, 1, 47, 48, 499, 998, 999}) {
+    auto copy = bytes;
+    copy[i] ^= 1;
+    BOOST_TEST(yk::hash_bytes(copy.data(), copy.size()) != base);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Hasher) {
+  const auto digest = []<class H>(H h, const void* data, std::size_t len) {
+    h(data, len);
+    return static_cast<typename H::result_type>(h);
+  };
+
+  BOOST_TEST(digest(yk::fnv1a{}, "", 0) == 0xcbf29ce484222325ull);
+  BOOST_TEST(digest(yk::fnv1a{}, "a", 1) == 0xaf63dc4c8601ec8cull);
+
+  // reference vectors: key = 00 01 .. 0f, message = 00 01 .. (len - 1)
+  std::array<unsigned char, 16> bytes;
+  for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<unsigned char>(i);
+  const auto k0 = yk::detail::wyhash::read8(bytes.data()), k1 = yk::detail::wyhash::read8(bytes.data() + 8);
+  BOOST_TEST(digest(yk::siphash{k0, k1}, bytes.data(), 0) == 0x726fdb47dd0e0e31ull);
+  BOOST_TEST(digest(yk::siphash{k0, k1}, bytes.data(), 15) == 0xa129ca6149be45e5ull);
+
+  // streaming == one shot, however the input is split
+  std::vector<unsigned char> input(500);
+  for (std::size_t i = 0; i < input.size(); ++i) input[i] = static_cast<unsigned char>(i * 131 + 17);
+  for (std::size_t len : {0, 3, 8, 16, 17, 48, 49, 64, 96, 97, 150, 500}) {
+    const auto expected_wy = yk::hash_bytes(input.data(), len, 7);
+    const auto expected_sip = digest(yk::siphash{k0, k1}, input.data(), len);
+    BOOST_TEST(digest(yk::wyhash{7}, input.data(), len) == expected_wy);
+
+    for (std::size_t step : {1, 5, 16, 47, 48, 49, 100}) {
+      yk::wyhash wy{7};
+      yk::siphash sip{k0, k1};
+      for (std::size_t pos = 0; pos < len; pos += step) {
+        wy(input.data() + pos, std::min(step, len - pos));
+        sip(input.data() + pos, std::min(step, len - pos));
+      }
+      BOOST_TEST(static_cast<std::uint64_t>(wy) == expected_wy);
+      BOOST_TEST(static_cast<std::uint64_t>(sip) == expected_sip);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HashAppend) {
+  using namespace std::literals;
+  const yk::uhash<> h;
+
+  // one stream for the whole struct
+  hash_test::Point p{1, 2, "foo"};
+  {
+    yk::wyhash expected;
+    int x = 1, y = 2;
+    expected(&x, sizeof(int));
+    expected(&y, sizeof(int));
+    expected("foo", 3);
+    std::size_t size = 3;
+    expected(&size, sizeof(size));
+    BOOST_TEST(h(p) == static_cast<std::uint64_t>(expected));
+  }
+  BOOST_TEST(std::hash<hash_test::Point>{}(p) == h(p));
+  BOOST_TEST(hash_value(p) == h(p));
+  BOOST_TEST(h(p) != h(hash_test::Point{2, 1, "foo"}));
+
+  // composites
+  BOOST_TEST(h(std::vector{"ab"s, "c"s}) != h(std::vector{"a"s, "bc"s}));
+  BOOST_TEST(h(std::pair{1, "x"s}) == h(std::tuple{1, "x"s}));
+  BOOST_TEST(h(std::optional<int>{}) != h(std::optional<int>{0}));
+  BOOST_TEST(h(std::variant<int, unsigned>{1}) != h(std::variant<int, unsigned>{1u}));
+  BOOST_TEST(h(0.0) == h(-0.0));
+  BOOST_TEST(h(0.0f) == h(-0.0f));
+  BOOST_TEST(h(0.0L) == h(-0.0L));
+  {
+    // x87 long double has padding bytes; dirty the stack between the calls so that they differ
+    const auto dirty_stack = [] {
+      volatile unsigned char garbage[256];
+      for (auto& c : garbage) c = 0xa5;
+    };
+    const long double x = 1.5L;
+    const auto first = h(x);
+    dirty_stack();
+    BOOST_TEST(h(x) == first);
+    BOOST_TEST(h(x) == h(1.5L));
+    BOOST_TEST(h(x) != h(2.5L));
+  }
+  BOOST_TEST(h("foo"s) == h("foo"sv));
+  BOOST_TEST(h(std::vector{p, p}) == h(std::array{p, p}));
+
+  // YK_ADAPT_HASH types append their size_t
+  hash_test::MultiS ms{1, 2, 3};
+  {
+    yk::wyhash expected;
+    const std::size_t value = hash_value(ms);
+    expected(&value, sizeof(value));
+    BOOST_TEST(h(ms) == static_cast<std::uint64_t>(expected));
+  }
+
+  // pluggable hashers
+  std::unordered_set<hash_test::Point, yk::uhash<yk::siphash>, decltype([](const auto& a, const auto& b) { return a.x == b.x && a.y == b.y && a.label == b.label; })> set(
+      8, yk::uhash<yk::siphash>{yk::siphash{0x0123456789abcdefull, 0xfedcba9876543210ull}});
+  set.insert(p);
+  set.insert(hash_test::Point{1, 2, "foo"});
+  set.insert(hash_test::Point{1, 2, "bar"});
+  BOOST_TEST(set.size() == 2);
+  BOOST_TEST(yk::uhash<yk::fnv1a>{}(p) != yk::uhash<yk::wyhash>{}(p));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,4 +1,7 @@
-﻿#include "yk/allocator/default_init_allocator.hpp"
+﻿#include "yk/allocator/arena.hpp"
+#include "yk/allocator/default_init_allocator.hpp"
+#include "yk/allocator/huge_page_allocator.hpp"
+#include "yk/allocator/pool_allocator.hpp"
 #include "yk/ranges/concat.hpp"
 #include "yk/printt.hpp"
 #include "yk/stack.hpp"
@@ -20,7 +23,9 @@
 #include <memory>
 #include <ranges>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <version>
@@ -55,6 +60,109 @@ BOOST_AUTO_TEST_CASE(Allocator) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(HugePageAllocator) {
+  static_assert(yk::xo::simple_allocator<yk::huge_page_allocator<int>>);
+
+  BOOST_TEST((yk::huge_page_allocator<int>{} == yk::huge_page_allocator<long>{}));
+  BOOST_TEST((yk::huge_page_allocator<int>{0} == yk::huge_page_allocator<int>{}));
+  BOOST_TEST((yk::huge_page_allocator<long>{yk::huge_page_allocator<int>{0}}.numa_node() == 0));
+
+  // small (operator new) and large (mapped) allocations
+  for (int numa_node : {yk::huge_page_allocator<int>::any_numa_node, 0}) {
+    {
+      std::vector<int, yk::huge_page_allocator<int>> v(16, 42, yk::huge_page_allocator<int>{numa_node});
+      BOOST_TEST(std::ranges::count(v, 42) == 16);
+    }
+    {
+      std::vector<std::uint64_t, yk::huge_page_allocator<std::uint64_t>> v(std::size_t{1} << 20, 0, yk::huge_page_allocator<std::uint64_t>{numa_node});
+      for (std::size_t i = 0; i < v.size(); ++i) v[i] = i;
+      BOOST_TEST(v.back() == v.size() - 1);
+    }
+  }
+
+  yk::stack<int, std::vector<int, yk::huge_page_allocator<int>>> s;
+  for (int i = 0; i < (1 << 20); ++i) s.push(i);
+  BOOST_TEST(s.top() == (1 << 20) - 1);
+
+  // containers on different nodes may exchange storage
+  {
+    std::vector<int, yk::huge_page_allocator<int>> a(std::size_t{1} << 20, 1, yk::huge_page_allocator<int>{0});
+    std::vector<int, yk::huge_page_allocator<int>> b(16, 2);
+    a.swap(b);
+    BOOST_TEST(a.size() == 16);
+    BOOST_TEST(b.size() == std::size_t{1} << 20);
+  }
+
+  // over-aligned types are not mapped, since the fallback mapping only guarantees page alignment
+  {
+    struct alignas(8192) over_aligned {
+      unsigned char bytes[8192];
+    };
+    std::vector<over_aligned, yk::huge_page_allocator<over_aligned>> v(256);
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(v.data()) % alignof(over_aligned) == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Arena) {
+  yk::arena arena{1024};
+
+  void* a = arena.allocate(10);
+  void* b = arena.allocate(10);
+  BOOST_TEST(a != b);
+  BOOST_TEST(reinterpret_cast<std::uintptr_t>(b) % alignof(std::max_align_t) == 0);
+
+  void* over_aligned = arena.allocate(10, 256);
+  BOOST_TEST(reinterpret_cast<std::uintptr_t>(over_aligned) % 256 == 0);
+
+  // larger than a block
+  BOOST_TEST(arena.allocate(4096) != nullptr);
+
+  {
+    std::vector<int, yk::arena_allocator<int>> v{arena};
+    for (int i = 0; i < 1000; ++i) v.push_back(i);
+    BOOST_TEST(v.back() == 999);
+  }
+
+  const auto capacity = arena.capacity();
+  arena.reset();
+  BOOST_TEST(arena.allocate(10) == a);
+  for (int i = 0; i < 100; ++i) (void)arena.allocate(10);
+  BOOST_TEST(arena.capacity() == capacity);
+
+  yk::arena other;
+  BOOST_TEST((yk::arena_allocator<int>{arena} == yk::arena_allocator<long>{arena}));
+  BOOST_TEST((yk::arena_allocator<int>{arena} != yk::arena_allocator<int>{other}));
+}
+
+BOOST_AUTO_TEST_CASE(PoolAllocator) {
+  static_assert(yk::xo::simple_allocator<yk::pool_allocator<int>>);
+
+  {
+    yk::pool_allocator<std::uint64_t> alloc;
+    std::uint64_t* p = alloc.allocate(3);
+    alloc.deallocate(p, 3);
+    BOOST_TEST(alloc.allocate(4) == p);  // same size class, recycled
+    alloc.deallocate(p, 4);
+  }
+
+  // blocks freed on another thread
+  {
+    std::vector<std::string*> strs;
+    yk::pool_allocator<std::string> alloc;
+    for (int i = 0; i < 100; ++i) strs.push_back(alloc.allocate(1));
+    std::thread{[&] {
+      for (auto* p : strs) alloc.deallocate(p, 1);
+    }}.join();
+  }
+
+  std::vector<int, yk::pool_allocator<int>> v;
+  for (int i = 0; i < 10000; ++i) v.push_back(i);  // mixes pooled and large blocks
+  BOOST_TEST(v.back() == 9999);
+
+  yk::stack<int, std::vector<int, yk::pool_allocator<int>>> s{1, 2, 3};
+  BOOST_TEST(s.top() == 3);
+}
+
 BOOST_AUTO_TEST_CASE(Stack) {
   yk::stack<int> s{3, 1, 4, 1, 5};
 
@@ -2,21 +2,89 @@
 
 #include "yk/exec/scheduler.hpp"
 #include "yk/exec/atomic_queue.hpp"
+#include "yk/exec/lockfree_stack.hpp"
+#include "yk/exec/object_pool.hpp"
+#include "yk/exec/port/boost_lockfree_spsc_queue.hpp"
+
+#include "yk/allocator/arena.hpp"
 
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <print>
 #include <format>
+#include <span>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <tuple>
 #include <ranges>
 #include <mutex>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <type_traits>
+#include <iterator>
+#include <stop_token>
+#include <utility>
+
+#include <cstddef>
 
 namespace {
+
+// single-pass input that yields [0, ready), then blocks like a source waiting on I/O
+// until released or until the worker pool stops
+class blocking_input : public std::ranges::view_interface<blocking_input> {
+public:
+  class iterator {
+  public:
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(const blocking_input* parent) noexcept : parent_(parent) {}
+
+    int operator*() const noexcept { return value_; }
+
+    iterator& operator++()
+    {
+      if (++value_ == parent_->ready_) {
+        while (!parent_->release_->load() && !parent_->stop_token_.stop_requested()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        done_ = true;
+      }
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept { return it.done_; }
+
+  private:
+    const blocking_input* parent_ = nullptr;
+    int value_ = 0;
+    bool done_ = false;
+  };
+
+  blocking_input() = default;
+  blocking_input(int ready, const std::atomic<bool>* release, std::stop_token stop_token) noexcept
+    : ready_(ready), release_(release), stop_token_(std::move(stop_token))
+  {}
+
+  iterator begin() const noexcept { return iterator{this}; }
+  std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+  int ready_ = 0;
+  const std::atomic<bool>* release_ = nullptr;
+  std::stop_token stop_token_;
+};
+
 } // anon
 
 BOOST_AUTO_TEST_SUITE(scheduler)
@@ -94,4 +162,871 @@ BOOST_AUTO_TEST_CASE(example)
   BOOST_TEST(std::ranges::equal(results, expected_results) == true);
 }
 
+BOOST_AUTO_TEST_CASE(worker_stats)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<long long> sum = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_wait(x)) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      int x;
+      if (!queue.pop_wait(x)) return;
+      sum += x;
+    },
+    std::views::iota(0, 10000),
+    1024
+  );
+
+  double utilization = -1.0;
+  sched.set_stats_tracker(std::make_unique<yk::exec::scheduler_stats_tracker>(
+    std::chrono::milliseconds{1},
+    [&](const yk::exec::scheduler_stats_tracker& tracker) {
+      utilization = tracker.utilization();
+    }
+  ));
+
+  BOOST_REQUIRE(sched.get_worker_stats().empty());
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+  BOOST_TEST(sum == 10000LL * 9999 / 2);
+
+  const auto worker_stats = sched.get_worker_stats();
+  BOOST_TEST(worker_stats.size() == 4);
+
+  yk::exec::scheduler_worker_stats total;
+  for (const auto& ws : worker_stats) {
+    BOOST_TEST(ws.utilization() >= 0.0);
+    BOOST_TEST(ws.utilization() <= 1.0);
+    total += ws;
+  }
+  BOOST_TEST(total.busy_time.count() > 0);
+  BOOST_TEST(total.total_time() >= total.busy_time);
+
+  BOOST_TEST(sched.get_stats_tracker()->worker_stats().size() == 4);
+  BOOST_TEST(utilization >= 0.0);
+  BOOST_TEST(utilization <= 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(worker_stats_rerun)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<long long> sum = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_wait(x)) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      int x;
+      if (!queue.pop_wait(x)) return;
+      sum += x;
+    },
+    std::views::iota(0, 10000),
+    64
+  );
+
+  for (int run = 1; run <= 3; ++run) {
+    if (run > 1) sched.reset_same_inputs_for_next_execution();
+
+    // the counters of the previous run are replaced here; its workers must be gone by then
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+    BOOST_TEST(sum == run * (10000LL * 9999 / 2));
+    BOOST_TEST(worker_pool->launched_worker_count() == 0); // joined
+
+    const auto stats = sched.get_stats();
+    BOOST_TEST(stats.consumer_input_processed == 10000);
+    BOOST_TEST(stats.is_all_task_done());
+
+    const auto worker_stats = sched.get_worker_stats();
+    BOOST_TEST(worker_stats.size() == 4);
+    yk::exec::scheduler_worker_stats total;
+    for (const auto& ws : worker_stats) total += ws;
+    BOOST_TEST(total.busy_time.count() > 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(scaler)
+{
+  yk::exec::scheduler_scaling_policy policy{
+    .min_workers = 2,
+    .max_workers = 4,
+    .patience = 2,
+  };
+  yk::exec::scheduler_scaler scaler{policy, 8};
+  BOOST_TEST(scaler.min_workers() == 2);
+  BOOST_TEST(scaler.max_workers() == 4);
+
+  // saturated
+  BOOST_TEST(scaler.update(2, 0.95, 0.0) == 2);
+  BOOST_TEST(scaler.update(2, 0.95, 0.0) == 3);
+  BOOST_TEST(scaler.update(3, 0.95, 0.0) == 3);
+  BOOST_TEST(scaler.update(3, 0.95, 0.0) == 4);
+  BOOST_TEST(scaler.update(4, 0.95, 0.0) == 4);
+  BOOST_TEST(scaler.update(4, 0.95, 0.0) == 4); // max
+
+  // queue-bound
+  scaler.reset();
+  BOOST_TEST(scaler.update(3, 0.1, 0.8) == 3);
+  BOOST_TEST(scaler.update(3, 0.1, 0.8) == 4);
+
+  // idle; a neutral tick resets the streak
+  BOOST_TEST(scaler.update(4, 0.1, 0.0) == 4);
+  BOOST_TEST(scaler.update(4, 0.7, 0.0) == 4);
+  BOOST_TEST(scaler.update(4, 0.1, 0.0) == 4);
+  BOOST_TEST(scaler.update(4, 0.1, 0.0) == 3);
+  BOOST_TEST(scaler.update(3, 0.1, 0.0) == 3);
+  BOOST_TEST(scaler.update(3, 0.1, 0.0) == 2);
+  BOOST_TEST(scaler.update(2, 0.1, 0.0) == 2);
+  BOOST_TEST(scaler.update(2, 0.1, 0.0) == 2); // min
+
+  // waiting on the queue once the producer input is consumed (the tail of a job) does not scale up
+  scaler.reset();
+  BOOST_TEST(scaler.update(3, 0.1, 0.8, false) == 3);
+  BOOST_TEST(scaler.update(3, 0.1, 0.8, false) == 2);
+  BOOST_TEST(scaler.update(2, 0.95, 0.8, false) == 2);
+  BOOST_TEST(scaler.update(2, 0.95, 0.8, false) == 3); // still busy
+
+  // available workers bound the policy
+  BOOST_TEST(yk::exec::scheduler_scaler(policy, 3).max_workers() == 3);
+
+  BOOST_CHECK_THROW(yk::exec::scheduler_scaler({.min_workers = 1}, 4), std::invalid_argument);
+  BOOST_CHECK_THROW(yk::exec::scheduler_scaler({.min_workers = 4, .max_workers = 3}, 4), std::invalid_argument);
+  BOOST_CHECK_THROW(yk::exec::scheduler_scaler({.scale_up_utilization = 0.4}, 4), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(scaling)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(6);
+
+  std::atomic<long long> sum = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_wait(x)) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      int x;
+      if (!queue.pop_wait(x)) return;
+      sum += x;
+    },
+    std::views::iota(0, 100000),
+    1024
+  );
+
+  sched.set_scaling_policy(yk::exec::scheduler_scaling_policy{.min_workers = 2, .max_workers = 4, .patience = 1});
+  BOOST_CHECK_THROW(sched.start(), std::invalid_argument); // no tracker
+
+  int min_active = 100, max_active = 0;
+  sched.set_stats_tracker(std::make_unique<yk::exec::scheduler_stats_tracker>(
+    std::chrono::milliseconds{1},
+    [&](const yk::exec::scheduler_stats_tracker&) {
+      const int active = sched.get_active_worker_count();
+      min_active = std::min(min_active, active);
+      max_active = std::max(max_active, active);
+    }
+  ));
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_TEST(sched.get_active_worker_count() >= 2);
+  BOOST_TEST(sched.get_active_worker_count() <= 4);
+
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+  BOOST_TEST(sum == 100000LL * 99999 / 2);
+
+  BOOST_TEST(min_active >= 2);
+  BOOST_TEST(max_active <= 4);
+  BOOST_TEST(sched.get_active_worker_count() >= 2);
+  BOOST_TEST(sched.get_active_worker_count() <= 4);
+
+  // workers beyond max_workers never ran
+  const auto worker_stats = sched.get_worker_stats();
+  BOOST_REQUIRE(worker_stats.size() == 6);
+  BOOST_TEST(worker_stats[4].busy_time.count() == 0);
+  BOOST_TEST(worker_stats[5].busy_time.count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(worker_budget)
+{
+  {
+    yk::exec::worker_budget budget{2};
+    BOOST_TEST(!budget.try_acquire(3));
+    BOOST_TEST(budget.try_acquire());
+    BOOST_TEST(!budget.try_acquire(2)); // all or nothing
+    BOOST_TEST(budget.try_acquire());
+    BOOST_TEST(!budget.try_acquire());
+    BOOST_TEST(!budget.try_acquire_for(std::stop_token{}, std::chrono::milliseconds{1}));
+
+    // a blocked acquire returns on cancel (after notify_all()), on stop request, and on release
+    {
+      std::atomic<bool> cancel = false;
+      std::jthread waiter{[&] { BOOST_TEST(!budget.acquire(std::stop_token{}, 1, [&] { return cancel.load(); })); }};
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      cancel = true;
+      budget.notify_all();
+    }
+    {
+      std::jthread waiter{[&](std::stop_token stop_token) { BOOST_TEST(!budget.acquire(stop_token, 1, [] { return false; })); }};
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    {
+      std::jthread waiter{[&] { BOOST_TEST(budget.acquire(std::stop_token{}, 2, [] { return false; })); }};
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+      budget.release(2);
+    }
+    BOOST_TEST(budget.in_use() == 2);
+
+    budget.release(2);
+    {
+      yk::exec::worker_budget_lease lease{&budget};
+      BOOST_TEST(!lease.held());
+      BOOST_TEST(lease.try_acquire());
+      BOOST_TEST(lease.held());
+      BOOST_TEST(budget.in_use() == 1);
+    }
+    BOOST_TEST(budget.in_use() == 0);
+
+    BOOST_CHECK_THROW(budget.set_limit(1), std::invalid_argument);
+
+    // threads
+    BOOST_TEST(budget.get_thread_limit() == 4);
+    BOOST_TEST(budget.try_add_threads(3) == 3);
+    BOOST_TEST(budget.try_add_threads(3) == 1);
+    budget.add_thread(); // counted beyond the limit
+    BOOST_TEST(budget.thread_count() == 5);
+    for (int i = 0; i < 5; ++i) budget.remove_thread();
+    BOOST_CHECK_THROW(budget.set_thread_limit(1), std::invalid_argument);
+  }
+  {
+    yk::exec::worker_budget_lease lease{nullptr}; // unlimited
+    BOOST_TEST(lease.held());
+    BOOST_TEST(lease.try_acquire());
+  }
+
+  // two schedulers of 6 workers each, sharing 6 running workers and 8 threads in total
+  auto budget = std::make_shared<yk::exec::worker_budget>(6);
+  budget->set_thread_limit(8);
+
+  auto make_pool = [&] {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(6);
+    worker_pool->set_worker_budget(budget);
+    return worker_pool;
+  };
+
+  auto make_sched = [](const std::shared_ptr<yk::exec::worker_pool>& worker_pool, std::atomic<long long>& sum) {
+    return yk::exec::make_scheduler<
+      yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+      yk::exec::atomic_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int x, auto& queue) {
+        if (!queue.push_wait(x)) return;
+      },
+      [&sum](yk::exec::thread_index_t, auto& queue) {
+        int x;
+        if (!queue.pop_wait(x)) return;
+        sum += x;
+      },
+      std::views::iota(0, 10000),
+      1024
+    );
+  };
+
+  std::atomic<long long> sum1 = 0, sum2 = 0;
+  auto pool1 = make_pool(), pool2 = make_pool();
+  auto sched1 = make_sched(pool1, sum1);
+  auto sched2 = make_sched(pool2, sum2);
+
+  // sampled while the schedulers run
+  std::atomic<int> max_in_use = 0, max_threads = 0, samples = 0;
+  const auto make_tracker = [&] {
+    return std::make_unique<yk::exec::scheduler_stats_tracker>(
+      std::chrono::milliseconds{1},
+      [&](const yk::exec::scheduler_stats_tracker&) {
+        int value = budget->in_use();
+        if (value > max_in_use) max_in_use = value;
+        value = budget->thread_count();
+        if (value > max_threads) max_threads = value;
+        ++samples;
+      }
+    );
+  };
+  sched1.set_stats_tracker(make_tracker());
+  sched2.set_stats_tracker(make_tracker());
+
+  BOOST_REQUIRE_NO_THROW(sched1.start());
+  BOOST_REQUIRE_NO_THROW(sched2.start());
+  BOOST_REQUIRE_NO_THROW(sched1.wait_for_all_tasks());
+  BOOST_REQUIRE_NO_THROW(sched2.wait_for_all_tasks());
+
+  BOOST_TEST(sum1 == 10000LL * 9999 / 2);
+  BOOST_TEST(sum2 == 10000LL * 9999 / 2);
+
+  BOOST_TEST(samples > 0);
+  BOOST_TEST(max_in_use <= 6); // the fixed pairs take their slots within the limit too
+  BOOST_TEST(max_threads <= 8 + 2 * 2); // plus the fixed pairs, which are launched regardless
+  BOOST_TEST(budget->thread_count() == 0); // joined by wait_for_all_tasks()
+
+  sched1.abort();
+  sched2.abort();
+  BOOST_TEST(budget->in_use() == 0);
+
+  // a budget smaller than the pool caps the threads it launches
+  {
+    auto small_budget = std::make_shared<yk::exec::worker_budget>(2); // 4 threads
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(6);
+    worker_pool->set_worker_budget(small_budget);
+
+    std::atomic<long long> sum = 0;
+    auto sched = make_sched(worker_pool, sum);
+    int max_launched = 0;
+    sched.set_stats_tracker(std::make_unique<yk::exec::scheduler_stats_tracker>(
+      std::chrono::milliseconds{1},
+      [&](const yk::exec::scheduler_stats_tracker&) {
+        max_launched = std::max(max_launched, worker_pool->launched_worker_count());
+      }
+    ));
+
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+    BOOST_TEST(sum == 10000LL * 9999 / 2);
+    BOOST_TEST(max_launched <= 4);
+    BOOST_TEST(small_budget->in_use() == 0);
+    BOOST_TEST(small_budget->thread_count() == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(worker_budget_lending)
+{
+  // an idle scheduler (waiting on its input, with an empty queue) gives its slots back only if a scaling policy parks its workers
+  auto run_idle = [](const std::optional<yk::exec::scheduler_scaling_policy>& policy) {
+    auto budget = std::make_shared<yk::exec::worker_budget>(6);
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(6);
+    worker_pool->set_worker_budget(budget);
+
+    std::atomic<bool> release = false;
+
+    auto sched = yk::exec::make_scheduler<
+      yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+      yk::exec::atomic_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int x, auto& queue) {
+        if (!queue.push_wait(x)) return;
+      },
+      [](yk::exec::thread_index_t, auto& queue) {
+        int x;
+        if (!queue.pop_wait(x)) return;
+      },
+      blocking_input{1, &release, worker_pool->stop_token()},
+      1
+    );
+    sched.set_scaling_policy(policy);
+    if (policy) {
+      sched.set_stats_tracker(std::make_unique<yk::exec::scheduler_stats_tracker>(
+        std::chrono::milliseconds{1},
+        [](const yk::exec::scheduler_stats_tracker&) {}
+      ));
+    }
+
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds{50}); // every worker is now blocked or parked
+    const int in_use = budget->in_use();
+
+    release = true;
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+    sched.abort();
+    BOOST_TEST(budget->in_use() == 0);
+    return in_use;
+  };
+
+  BOOST_TEST(run_idle(std::nullopt) == 6);
+  BOOST_TEST(run_idle(yk::exec::scheduler_scaling_policy{.min_workers = 2, .max_workers = 2}) == 2); // only the fixed producer and consumer
+}
+
+BOOST_AUTO_TEST_CASE(drain)
+{
+  const auto make = [](const std::shared_ptr<yk::exec::worker_pool>& worker_pool, std::chrono::microseconds consumer_delay) {
+    return yk::exec::make_scheduler<
+      yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+      yk::exec::atomic_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int x, auto& queue) {
+        if (!queue.push_wait(x)) return;
+      },
+      [consumer_delay](yk::exec::thread_index_t, auto& queue) {
+        int x;
+        if (!queue.pop_wait(x)) return;
+        std::this_thread::sleep_for(consumer_delay);
+      },
+      std::views::iota(0, 100000),
+      64
+    );
+  };
+
+  // finishes in time
+  {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(4);
+
+    auto sched = make(worker_pool, std::chrono::microseconds{10});
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    BOOST_TEST(sched.drain(std::chrono::steady_clock::now() + std::chrono::seconds{30}));
+
+    const auto stats = sched.get_stats();
+    BOOST_TEST(stats.is_all_task_done());
+    BOOST_TEST(stats.producer_input_processed + stats.producer_input_dropped == 100000);
+    BOOST_TEST(stats.producer_input_dropped > 0);
+    BOOST_TEST(stats.consumer_input_dropped == 0);
+    BOOST_TEST(stats.consumer_input_processed == stats.producer_output);
+  }
+
+  // deadline exceeded
+  {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(4);
+
+    auto sched = make(worker_pool, std::chrono::milliseconds{10});
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    BOOST_TEST(!sched.drain(std::chrono::steady_clock::now() + std::chrono::milliseconds{1}));
+
+    const auto stats = sched.get_stats();
+    BOOST_TEST(!stats.is_all_task_done());
+    BOOST_TEST(stats.producer_input_processed + stats.producer_input_dropped == 100000);
+    BOOST_TEST(stats.consumer_input_dropped > 0);
+    BOOST_TEST(stats.consumer_input_processed + stats.consumer_input_dropped == stats.producer_output);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(streaming_input)
+{
+  const auto run = [](std::istream& is, long long& sum) {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(4);
+
+    std::atomic<long long> atomic_sum = 0;
+
+    auto sched = yk::exec::make_scheduler<
+      yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+      yk::exec::atomic_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int&& x, auto& queue) {
+        if (!queue.push_wait(x)) return;
+      },
+      [&](yk::exec::thread_index_t, auto& queue) {
+        int x;
+        if (!queue.pop_wait(x)) return;
+        atomic_sum += x;
+      },
+      std::views::istream<int>(is), // single-pass, unsized
+      1024
+    );
+    static_assert(decltype(sched)::traits_type::is_streaming_input);
+
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+    sum = atomic_sum;
+    return sched.get_stats();
+  };
+
+  {
+    std::string text;
+    for (int i = 0; i < 10000; ++i) text += std::to_string(i) + ' ';
+    std::istringstream iss{text};
+
+    long long sum = 0;
+    const auto stats = run(iss, sum);
+    BOOST_TEST(sum == 10000LL * 9999 / 2);
+    BOOST_TEST(stats.producer_input_total == yk::exec::scheduler_stats::UNPREDICTABLE);
+    BOOST_TEST(stats.producer_input_remaining() == yk::exec::scheduler_stats::UNPREDICTABLE);
+    BOOST_TEST(stats.producer_input_consumed == 10000);
+    BOOST_TEST(stats.producer_input_processed == 10000);
+    BOOST_TEST(stats.is_all_task_done());
+  }
+  {
+    std::istringstream iss{""};
+
+    long long sum = -1;
+    const auto stats = run(iss, sum);
+    BOOST_TEST(sum == 0);
+    BOOST_TEST(stats.producer_input_consumed == 0);
+    BOOST_TEST(stats.is_all_task_done());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(drain_blocking_input)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<bool> release = false;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_wait(x)) return;
+    },
+    [](yk::exec::thread_index_t, auto& queue) {
+      int x;
+      if (!queue.pop_wait(x)) return;
+    },
+    blocking_input{100, &release, worker_pool->stop_token()},
+    16
+  );
+  static_assert(decltype(sched)::traits_type::is_streaming_input);
+
+  // unblocks the input eventually, so that a drain() stuck behind the pull fails the timing check instead of hanging
+  std::jthread watchdog{[&](std::stop_token stop_token) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+    while (!stop_token.stop_requested() && std::chrono::steady_clock::now() < until) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    release = true;
+  }};
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds{50}); // a producer is now blocked pulling the last chunk
+
+  const auto start = std::chrono::steady_clock::now();
+  BOOST_TEST(sched.drain(start + std::chrono::milliseconds{100}));
+  BOOST_TEST((std::chrono::steady_clock::now() - start < std::chrono::seconds{1}));
+
+  const auto stats = sched.get_stats();
+  BOOST_TEST(stats.producer_input_consumed < 100); // the values of the blocked pull are dropped
+  BOOST_TEST(stats.producer_input_processed == stats.producer_input_consumed);
+  BOOST_TEST(stats.is_all_task_done());
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_abort)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  using pool_type = yk::exec::object_pool<std::vector<int>>;
+  pool_type objects(4);
+
+  // the consumers never give the objects back, so the producers end up waiting in acquire()
+  std::mutex held_mtx;
+  std::vector<pool_type::handle> held;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<pool_type::handle>
+  >(
+    worker_pool,
+    [&](yk::exec::thread_index_t, int x, auto& queue) {
+      auto handle = objects.acquire(worker_pool->stop_token());
+      if (!handle) {
+        queue.discard(); // cancelled
+        return;
+      }
+      handle->assign(1, x);
+      if (!queue.push_wait(std::move(handle))) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      pool_type::handle handle;
+      if (!queue.pop_wait(handle)) return;
+      std::scoped_lock lock{held_mtx};
+      held.push_back(std::move(handle));
+    },
+    std::views::iota(0, 100),
+    1
+  );
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+  const auto start = std::chrono::steady_clock::now();
+  sched.abort();
+  BOOST_TEST((std::chrono::steady_clock::now() - start < std::chrono::seconds{1}));
+  BOOST_TEST(held.size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(visit)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<long long> sum = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_visit([x](int& value) noexcept { value = x; })) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      if (!queue.pop_visit([&](int& value) { sum += value; })) return;
+    },
+    std::views::iota(0, 10000),
+    1024
+  );
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+  BOOST_TEST(sum == 10000LL * 9999 / 2);
+}
+
+BOOST_AUTO_TEST_CASE(start_callback)
+{
+  using arena_string = std::basic_string<char, std::char_traits<char>, yk::arena_allocator<char>>;
+  constexpr std::string_view payload = "a string long enough to defeat the small string optimization";
+
+  yk::arena arena{4096};
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<int> matched = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::single_push, yk::exec::consumer_kind::single_pop,
+    yk::exec::atomic_queue<arena_string>
+  >(
+    worker_pool,
+    [&](yk::exec::thread_index_t, int, auto& queue) {
+      if (!queue.push_wait(arena_string{payload, arena})) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      arena_string s{arena};
+      if (!queue.pop_wait(s)) return;
+      if (s == payload) ++matched;
+    },
+    std::views::iota(0, 1000),
+    64
+  );
+
+  // leftovers of a previous run
+  for (int i = 0; i < 100; ++i) (void)arena.allocate(1000);
+  const auto capacity_before = arena.capacity();
+
+  int started = 0;
+  sched.set_start_callback([&] {
+    ++started;
+    arena.reset();
+  });
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+
+  BOOST_TEST(started == 1);
+  BOOST_TEST(matched == 1000);
+  BOOST_TEST(arena.capacity() <= capacity_before); // the retained blocks were reused
+
+  // a real second run; the callback resets the arena while the first run's strings are all destroyed
+  const auto capacity_after_first_run = arena.capacity();
+  sched.reset_same_inputs_for_next_execution();
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+
+  BOOST_TEST(started == 2);
+  BOOST_TEST(matched == 2000);
+  BOOST_TEST(arena.capacity() == capacity_after_first_run);
+}
+
+BOOST_AUTO_TEST_CASE(lockfree_stack)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<long long> sum = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::multi_push, yk::exec::consumer_kind::multi_pop,
+    yk::exec::lockfree_stack<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_wait(x)) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      int x;
+      if (!queue.pop_wait(x)) return;
+      sum += x;
+    },
+    std::views::iota(0, 10000),
+    64
+  );
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+  BOOST_TEST(sum == 10000LL * 9999 / 2);
+}
+
+BOOST_AUTO_TEST_CASE(closable_atomic_queue)
+{
+  auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+  worker_pool->set_worker_limit(4);
+
+  std::atomic<long long> sum = 0;
+
+  auto sched = yk::exec::make_scheduler<
+    yk::exec::producer_kind::multi_push, yk::exec::consumer_kind::multi_pop,
+    yk::exec::closable_atomic_queue<int>
+  >(
+    worker_pool,
+    [](yk::exec::thread_index_t, int x, auto& queue) {
+      if (!queue.push_wait(x)) return;
+    },
+    [&](yk::exec::thread_index_t, auto& queue) {
+      int x;
+      if (!queue.pop_wait(x)) return;
+      sum += x;
+    },
+    std::views::iota(0, 10000),
+    64
+  );
+
+  BOOST_REQUIRE_NO_THROW(sched.start());
+  BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+  BOOST_TEST(sum == 10000LL * 9999 / 2); // every value pushed before close() is consumed
+}
+
+BOOST_AUTO_TEST_CASE(bulk)
+{
+  const auto make = [](const std::shared_ptr<yk::exec::worker_pool>& worker_pool, std::atomic<long long>& sum) {
+    return yk::exec::make_scheduler<
+      yk::exec::producer_kind::multi_push, yk::exec::consumer_kind::multi_pop,
+      boost::lockfree::spsc_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int x, auto& queue) {
+        const std::array<int, 4> values{x, x, x, x};
+        if (queue.push_range_wait(values) != values.size()) return;
+      },
+      [&sum](yk::exec::thread_index_t, auto& queue) {
+        std::array<int, 16> values;
+        const auto n = queue.pop_bulk_wait(values);
+        for (std::size_t i = 0; i < n; ++i) sum += values[i];
+      },
+      std::views::iota(0, 10000),
+      64
+    );
+  };
+
+  {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(2);
+
+    std::atomic<long long> sum = 0;
+    auto sched = make(worker_pool, sum);
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+
+    BOOST_TEST(sum == 4 * (10000LL * 9999 / 2));
+    const auto stats = sched.get_stats();
+    BOOST_TEST(stats.producer_output == 40000);
+    BOOST_TEST(stats.consumer_input_processed == 40000);
+  }
+
+  // the fixed producer must not become a second consumer of the SPSC queue once its inputs run out
+  {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(2);
+
+    std::atomic<long long> sum = 0;
+    std::atomic<long long> consumer_id = -1;
+    std::atomic<bool> shared_consumer = false;
+    auto sched = yk::exec::make_scheduler<
+      yk::exec::producer_kind::multi_push, yk::exec::consumer_kind::multi_pop,
+      boost::lockfree::spsc_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int x, auto& queue) {
+        (void)queue.push_range_wait(std::array<int, 4>{x, x, x, x});
+      },
+      [&](yk::exec::thread_index_t worker_id, auto& queue) {
+        long long expected = -1;
+        if (!consumer_id.compare_exchange_strong(expected, static_cast<long long>(worker_id)) && expected != static_cast<long long>(worker_id)) {
+          shared_consumer = true;
+        }
+        std::array<int, 16> values;
+        const auto n = queue.pop_bulk_wait(values);
+        std::this_thread::sleep_for(std::chrono::microseconds{10}); // let the producer run out of inputs first
+        for (std::size_t i = 0; i < n; ++i) sum += values[i];
+      },
+      std::views::iota(0, 1000),
+      64
+    );
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+    BOOST_TEST(!shared_consumer);
+    BOOST_TEST(sum == 4 * (1000LL * 999 / 2));
+  }
+
+  // SPSC queues allow the fixed producer and consumer only
+  {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(4);
+
+    std::atomic<long long> sum = 0;
+    auto sched = make(worker_pool, sum);
+    BOOST_CHECK_THROW(sched.start(), std::invalid_argument);
+  }
+
+  // fallback for queues without native batch operations
+  {
+    auto worker_pool = std::make_shared<yk::exec::worker_pool>();
+    worker_pool->set_worker_limit(4);
+
+    std::atomic<long long> sum = 0;
+    std::atomic<std::size_t> max_popped = 0;
+    auto sched = yk::exec::make_scheduler<
+      yk::exec::producer_kind::multi_push, yk::exec::consumer_kind::multi_pop,
+      yk::exec::atomic_queue<int>
+    >(
+      worker_pool,
+      [](yk::exec::thread_index_t, int x, auto& queue) {
+        (void)queue.push_range_wait(std::array<int, 2>{x, x});
+      },
+      [&](yk::exec::thread_index_t, auto& queue) {
+        std::array<int, 16> values;
+        const auto n = queue.pop_bulk_wait(values);
+        if (n > max_popped) max_popped = n;
+        for (std::size_t i = 0; i < n; ++i) sum += values[i];
+      },
+      std::views::iota(0, 1000),
+      64
+    );
+    BOOST_REQUIRE_NO_THROW(sched.start());
+    BOOST_REQUIRE_NO_THROW(sched.wait_for_all_tasks());
+    BOOST_TEST(sum == 2 * (1000LL * 999 / 2));
+    BOOST_TEST(max_popped == 1u);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,6 @@
 #define YK_VARIANT_INCLUDE_STD 1
 #define YK_VARIANT_INCLUDE_BOOST 1
+#include "yk/hash/hash_append.hpp"
 #include "yk/util/overloaded.hpp"
 #include "yk/util/specialization_of.hpp"
 
@@ -436,6 +437,8 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(Hash, Variant, YK_VARIANT(int, double, std::string
       yk::variant_view<Variant, int, double>{c},
   };
   BOOST_TEST(set.size() == 2);
+
+  BOOST_TEST(yk::uhash<>{}(yk::variant_view<Variant, int, double>{a}) == yk::uhash<>{}(a));
 }
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(Index, Variant, YK_VARIANT(int, double, std::string)) {